@@ -0,0 +1,192 @@
+/*
+ * Allocation Tracking for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "alloc_tracker.h"
+#include "metrics.h"
+#include "trace_log.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Counters are updated from inside operator new, so everything here is
+// constant-initialized and nothing allocates
+struct AllocationSlot {
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> frees;
+    std::atomic<uint64_t> bytes;
+    std::atomic<uint64_t> critical;
+};
+
+static AllocationSlot threadSlots[ALLOC_MAX_THREADS];
+static AllocationSlot stateSlots[ALLOC_MAX_STATES];
+static std::atomic<int> slotsClaimed(0);
+static std::atomic<int> allocationPolicy(ALLOC_POLICY_LOG);
+
+static thread_local int threadSlot = -1;
+static thread_local int allocationState = 0;  // Each trainer shard sets its own
+static thread_local const char* criticalSection = nullptr;
+
+static AllocationSlot* currentThreadSlot() {
+    if (threadSlot < 0) {
+        threadSlot = std::min(slotsClaimed.fetch_add(1, std::memory_order_relaxed), ALLOC_MAX_THREADS - 1);
+    }
+    return &threadSlots[threadSlot];
+}
+
+static AllocationCounts readSlot(const AllocationSlot& slot) {
+    AllocationCounts counts;
+    counts.allocations = slot.allocations.load(std::memory_order_relaxed);
+    counts.frees = slot.frees.load(std::memory_order_relaxed);
+    counts.bytes = slot.bytes.load(std::memory_order_relaxed);
+    counts.critical = slot.critical.load(std::memory_order_relaxed);
+    return counts;
+}
+
+AllocationGuard::AllocationGuard(const char* section) : previous(criticalSection) {
+    criticalSection = section;
+}
+
+AllocationGuard::~AllocationGuard() {
+    criticalSection = previous;
+}
+
+bool allocationTrackingEnabled() {
+#if defined(TRACK_ALLOCATIONS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void setAllocationPolicy(AllocationPolicy policy) {
+    allocationPolicy.store(policy, std::memory_order_relaxed);
+}
+
+void setAllocationState(int state) {
+    allocationState = std::max(0, std::min(state, ALLOC_MAX_STATES - 1));
+}
+
+AllocationCounts threadAllocationCounts() {
+    return readSlot(*currentThreadSlot());
+}
+
+AllocationCounts threadAllocationCounts(int slot) {
+    if (slot < 0 || slot >= allocationThreadCount()) return AllocationCounts();
+    return readSlot(threadSlots[slot]);
+}
+
+int allocationThreadCount() {
+    return std::min(slotsClaimed.load(std::memory_order_relaxed), ALLOC_MAX_THREADS);
+}
+
+AllocationCounts stateAllocationCounts(int state) {
+    if (state < 0 || state >= ALLOC_MAX_STATES) return AllocationCounts();
+    return readSlot(stateSlots[state]);
+}
+
+// Global Allocation Hooks
+
+#if defined(TRACK_ALLOCATIONS)
+
+static thread_local bool reporting = false;  // Set while an allocation is being reported
+
+static void countAllocation(AllocationSlot* slot, size_t size, bool critical) {
+    slot->allocations.fetch_add(1, std::memory_order_relaxed);
+    slot->bytes.fetch_add(size, std::memory_order_relaxed);
+    if (critical) slot->critical.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void recordAllocation(size_t size) {
+    bool critical = criticalSection != nullptr;
+    countAllocation(currentThreadSlot(), size, critical);
+    countAllocation(&stateSlots[allocationState], size, critical);
+    if (!critical || reporting) return;
+
+    // Reporting may allocate itself (a thread's first trace record does)
+    reporting = true;
+    incrementMetric(METRIC_CRITICAL_ALLOCATIONS);
+    switch (allocationPolicy.load(std::memory_order_relaxed)) {
+        case ALLOC_POLICY_LOG:
+            traceLog(TRACE_CRITICAL_ALLOCATION, static_cast<double>(size));
+            break;
+        case ALLOC_POLICY_ABORT:
+            std::fprintf(stderr, "Allocation of %zu bytes in critical section '%s'\n", size, criticalSection);
+            std::abort();
+        default:
+            break;
+    }
+    reporting = false;
+}
+
+static void recordFree(void* pointer) {
+    if (pointer) currentThreadSlot()->frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void* trackedAllocate(size_t size) {
+    recordAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+static void* trackedAllocate(size_t size, std::align_val_t alignment) {
+    recordAllocation(size);
+    size_t align = std::max(static_cast<size_t>(alignment), sizeof(void*));
+    size_t rounded = (std::max<size_t>(size, 1) + align - 1) / align * align;  // aligned_alloc requires a multiple
+    return std::aligned_alloc(align, rounded);
+}
+
+static void trackedFree(void* pointer) {
+    recordFree(pointer);
+    std::free(pointer);
+}
+
+void* operator new(size_t size) {
+    void* pointer = trackedAllocate(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](size_t size) {
+    void* pointer = trackedAllocate(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    void* pointer = trackedAllocate(size, alignment);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    void* pointer = trackedAllocate(size, alignment);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return trackedAllocate(size, alignment);
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return trackedAllocate(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+
+#endif
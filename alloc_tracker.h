@@ -0,0 +1,56 @@
+/*
+ * Allocation Tracking for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Opt-in: building with -DTRACK_ALLOCATIONS (make debug does) replaces the
+ * global operator new and delete with versions that count allocations per
+ * thread and per system state. An AllocationGuard marks a critical section
+ * in which any allocation is logged or aborts the program, depending on
+ * the policy. Without the flag the counts stay zero and guards cost one
+ * thread-local store.
+ */
+
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <cstdint>
+
+// Tracker Configuration
+const int ALLOC_MAX_THREADS = 16;  // Later threads share the last slot
+const int ALLOC_MAX_STATES = 8;    // Indexed by SystemState
+
+// What an allocation inside an AllocationGuard does
+enum AllocationPolicy {
+    ALLOC_POLICY_COUNT,  // Count it only
+    ALLOC_POLICY_LOG,    // Count it and trace its size
+    ALLOC_POLICY_ABORT   // Report it on stderr and abort
+};
+
+struct AllocationCounts {
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t bytes;     // Requested, not counting allocator overhead
+    uint64_t critical;  // Allocations inside an AllocationGuard
+
+    AllocationCounts() : allocations(0), frees(0), bytes(0), critical(0) {}
+};
+
+// Marks the lifetime of the object as a no-allocation section; name must be
+// a string literal. Guards nest.
+struct AllocationGuard {
+    const char* previous;
+
+    explicit AllocationGuard(const char* section);
+    ~AllocationGuard();
+};
+
+// Function Declarations
+bool allocationTrackingEnabled();
+void setAllocationPolicy(AllocationPolicy policy);
+void setAllocationState(int state);                  // For the calling thread
+AllocationCounts threadAllocationCounts();           // Calling thread
+AllocationCounts threadAllocationCounts(int slot);   // 0 .. allocationThreadCount() - 1
+int allocationThreadCount();
+AllocationCounts stateAllocationCounts(int state);
+
+#endif // ALLOC_TRACKER_H
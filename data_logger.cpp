@@ -0,0 +1,377 @@
+/*
+ * Data Logger for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "data_logger.h"
+#include "log_block.h"
+#include "trajectory_quant.h"
+#include "trajectory_index.h"
+#include "trace_log.h"
+#include "span_trace.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Fixed part of a shot record: version, timestamp, peak, duration, score
+// and start/end positions. Version 1 follows it with a point count and raw
+// doubles, version 2 with a quantized trajectory, version 3 with an
+// outcome byte and then a quantized trajectory.
+const size_t SHOT_RECORD_HEADER_SIZE = 1 + 8 + 8 + 8 + 8 + 6 * 8;
+const uint8_t SHOT_RECORD_VERSION_RAW = 1;
+const uint8_t SHOT_RECORD_VERSION_QUANTIZED = 2;
+
+static void putVector(std::vector<uint8_t>* out, const Vector3D& vec) {
+    putDouble(out, vec.x);
+    putDouble(out, vec.y);
+    putDouble(out, vec.z);
+}
+
+static Vector3D getVector(const uint8_t* in) {
+    return Vector3D(getDouble(in), getDouble(in + 8), getDouble(in + 16));
+}
+
+void serializeShotData(const ShotData* shot, std::vector<uint8_t>* out) {
+    QuantizedTrajectory quantized;
+    quantizeTrajectory(shot->trajectory, &quantized);
+
+    size_t points = quantized.size();
+    if (points > MAX_TRAJECTORY_POINTS) {
+        points = MAX_TRAJECTORY_POINTS;
+        quantized.x.resize(points);
+        quantized.y.resize(points);
+        quantized.z.resize(points);
+    }
+
+    out->reserve(out->size() + SHOT_RECORD_HEADER_SIZE + 1 + quantizedTrajectoryBytes(points));
+    out->push_back(SHOT_RECORD_VERSION);
+    putU64(out, shot->timestamp);
+    putDouble(out, shot->peakAccel);
+    putU64(out, shot->duration);
+    putDouble(out, shot->formScore);
+    putVector(out, shot->startPosition);
+    putVector(out, shot->endPosition);
+    out->push_back(shot->wasSuccessful ? 1 : 0);
+    serializeQuantizedTrajectory(quantized, out);
+}
+
+bool deserializeShotData(const uint8_t* data, size_t length, ShotData* shot) {
+    if (length < SHOT_RECORD_HEADER_SIZE) return false;
+    uint8_t version = data[0];
+    if (version != SHOT_RECORD_VERSION && version != SHOT_RECORD_VERSION_QUANTIZED &&
+        version != SHOT_RECORD_VERSION_RAW) {
+        return false;
+    }
+
+    const uint8_t* in = data + 1;
+    shot->timestamp = getU64(in);
+    shot->peakAccel = getDouble(in + 8);
+    shot->duration = getU64(in + 16);
+    shot->formScore = getDouble(in + 24);
+    shot->startPosition = getVector(in + 32);
+    shot->endPosition = getVector(in + 56);
+    in += 80;
+    length -= SHOT_RECORD_HEADER_SIZE;
+
+    // Outcomes were not recorded before version 3
+    shot->wasSuccessful = false;
+    if (version == SHOT_RECORD_VERSION) {
+        if (length < 1) return false;
+        shot->wasSuccessful = *in++ != 0;
+        length--;
+    }
+
+    if (version != SHOT_RECORD_VERSION_RAW) {
+        QuantizedTrajectory quantized;
+        if (!deserializeQuantizedTrajectory(in, length, &quantized)) {
+            return false;
+        }
+        dequantizeTrajectory(quantized, &shot->trajectory);
+        return true;
+    }
+
+    // Version 1 records from before quantization
+    if (length < 2) return false;
+    size_t points = getU16(in);
+    in += 2;
+    if (length != 2 + points * 24) return false;
+
+    shot->trajectory.clear();
+    for (size_t i = 0; i < points; i++, in += 24) {
+        shot->trajectory.push_back(getVector(in));
+    }
+    return true;
+}
+
+// Session Recording
+// Each block: version, sample count, then per sample a u64 timestamp and
+// seven floats (accel, gyro, magnitude)
+const size_t SESSION_SAMPLE_BYTES = 8 + 7 * 4;
+
+bool saveSessionRecording(const std::string& filename, const std::vector<MotionData>& samples) {
+    std::vector<uint8_t> block;
+    for (size_t first = 0; first < samples.size(); first += SESSION_SAMPLES_PER_BLOCK) {
+        size_t count = std::min(samples.size() - first, static_cast<size_t>(SESSION_SAMPLES_PER_BLOCK));
+
+        block.clear();
+        block.push_back(SESSION_RECORD_VERSION);
+        putU16(&block, static_cast<uint16_t>(count));
+        for (size_t i = first; i < first + count; i++) {
+            const MotionData& sample = samples[i];
+            putU64(&block, sample.timestamp);
+            putFloat(&block, sample.accel.x);
+            putFloat(&block, sample.accel.y);
+            putFloat(&block, sample.accel.z);
+            putFloat(&block, sample.gyro.x);
+            putFloat(&block, sample.gyro.y);
+            putFloat(&block, sample.gyro.z);
+            putFloat(&block, sample.magnitude);
+        }
+        if (!appendLogBlock(filename, block.data(), block.size())) return false;
+    }
+    return true;
+}
+
+bool loadSessionRecording(const std::string& filename, std::vector<MotionData>* samples) {
+    std::vector<std::vector<uint8_t>> blocks;
+    if (!readLogBlocks(filename, &blocks)) return false;
+
+    samples->clear();
+    for (const std::vector<uint8_t>& block : blocks) {
+        if (block.size() < 3 || block[0] != SESSION_RECORD_VERSION) return false;
+        size_t count = getU16(block.data() + 1);
+        if (block.size() != 3 + count * SESSION_SAMPLE_BYTES) return false;
+
+        const uint8_t* in = block.data() + 3;
+        for (size_t i = 0; i < count; i++, in += SESSION_SAMPLE_BYTES) {
+            MotionData sample;
+            sample.timestamp = getU64(in);
+            sample.accel = Vector3D(getFloat(in + 8), getFloat(in + 12), getFloat(in + 16));
+            sample.gyro = Vector3D(getFloat(in + 20), getFloat(in + 24), getFloat(in + 28));
+            sample.magnitude = getFloat(in + 32);
+            samples->push_back(sample);
+        }
+    }
+    return true;
+}
+
+bool saveShotToFile(const ShotData* shot) {
+    ScopedSpan span("saveShotToFile");
+    std::vector<uint8_t> record;
+    serializeShotData(shot, &record);
+
+    if (!appendLogBlock(SHOT_LOG_FILE, record.data(), record.size())) {
+        std::cout << "Failed to write shot record to " << SHOT_LOG_FILE << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Shot Log Writer
+//
+// Shots are analyzed on the trainer threads, where nothing may allocate or
+// block on the file system. They are copied into a bounded ring (after
+// D. Vyukov, as in haptic_queue.cpp) whose slots have their trajectory
+// reserved up front, and a writer thread serializes and appends them.
+
+const uint64_t SHOT_LOG_QUEUE_MASK = SHOT_LOG_QUEUE_CAPACITY - 1;
+
+static_assert((SHOT_LOG_QUEUE_CAPACITY & (SHOT_LOG_QUEUE_CAPACITY - 1)) == 0, "capacity must be a power of two");
+
+struct ShotLogCell {
+    std::atomic<uint64_t> sequence;
+    ShotData shot;  // Trajectory reserved for MAX_TRAJECTORY_POINTS
+};
+
+struct ShotLogQueue {
+    ShotLogCell cells[SHOT_LOG_QUEUE_CAPACITY];
+    alignas(64) std::atomic<uint64_t> tail;  // Producers
+    alignas(64) std::atomic<uint64_t> head;  // Writer thread
+};
+
+static ShotLogQueue shotLogQueue;
+static std::thread shotLogThread;
+static std::mutex shotLogLock;
+static std::condition_variable shotLogWake;
+static bool shotLogRunning = false;
+
+static void initShotLogQueue(ShotLogQueue* queue) {
+    for (int i = 0; i < SHOT_LOG_QUEUE_CAPACITY; i++) {
+        queue->cells[i].sequence.store(i, std::memory_order_relaxed);
+        queue->cells[i].shot.trajectory.reserve(MAX_TRAJECTORY_POINTS);
+    }
+    queue->tail.store(0, std::memory_order_relaxed);
+    queue->head.store(0, std::memory_order_release);
+}
+
+bool queueShotForLogging(const ShotData* shot) {
+    ShotLogQueue* queue = &shotLogQueue;
+    uint64_t position = queue->tail.load(std::memory_order_relaxed);
+    ShotLogCell* cell;
+    while (true) {
+        cell = &queue->cells[position & SHOT_LOG_QUEUE_MASK];
+        uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        int64_t lag = static_cast<int64_t>(sequence - position);
+        if (lag == 0) {
+            if (queue->tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        } else if (lag < 0) {
+            return false;  // Full: the writer has not caught up
+        } else {
+            position = queue->tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Field by field so the slot keeps its reserved trajectory
+    ShotData& slot = cell->shot;
+    slot.timestamp = shot->timestamp;
+    slot.peakAccel = shot->peakAccel;
+    slot.duration = shot->duration;
+    slot.formScore = shot->formScore;
+    slot.wasSuccessful = shot->wasSuccessful;
+    slot.startPosition = shot->startPosition;
+    slot.endPosition = shot->endPosition;
+    size_t points = std::min(shot->trajectory.size(), static_cast<size_t>(MAX_TRAJECTORY_POINTS));
+    slot.trajectory.assign(shot->trajectory.begin(), shot->trajectory.begin() + points);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+// Shot Library
+//
+// Every logged shot, indexed by trajectory. Touched only by the writer
+// thread: it loads the shot log once the tail is recovered, then matches
+// each new shot against the earlier ones before adding it.
+
+static TrajectoryIndex shotLibrary;
+static unsigned long loggedShots = 0;  // Records in the shot log; a shot's id is its position
+
+static bool addToShotLibrary(const ShotData* shot, unsigned long shotId) {
+    TrajectoryRecord record;
+    record.shotId = shotId;
+    record.timestamp = shot->timestamp;
+    record.wasSuccessful = shot->wasSuccessful;
+    quantizeTrajectory(shot->trajectory, &record.trajectory);
+    return insertTrajectory(&shotLibrary, record);
+}
+
+static void loadShotLibrary() {
+    shotLibrary = TrajectoryIndex();
+    loggedShots = 0;
+    std::vector<std::vector<uint8_t>> blocks;
+    size_t skipped = 0;
+    if (!readIntactLogBlocks(SHOT_LOG_FILE, &blocks, &skipped)) return;  // No log yet
+
+    // A damaged block costs only its own shot
+    ShotData shot;
+    for (const std::vector<uint8_t>& block : blocks) {
+        loggedShots++;
+        if (deserializeShotData(block.data(), block.size(), &shot)) {
+            addToShotLibrary(&shot, loggedShots);
+        } else {
+            skipped++;
+        }
+    }
+    std::cout << "Shot library: " << trajectoryIndexSize(&shotLibrary) << " shots";
+    if (skipped > 0) std::cout << ", " << skipped << " unreadable blocks skipped";
+    std::cout << std::endl;
+}
+
+static void matchShot(const ShotData* shot) {
+    std::vector<TrajectoryMatch> matches;
+    if (findSimilarTrajectories(&shotLibrary, shot->trajectory, 1, &matches) > 0) {
+        traceLog(TRACE_SHOT_MATCH, static_cast<double>(matches[0].shotId), matches[0].similarity);
+    }
+}
+
+// Writes every queued shot in place, then frees its slot
+static size_t drainShotLog(ShotLogQueue* queue) {
+    size_t written = 0;
+    while (true) {
+        uint64_t position = queue->head.load(std::memory_order_relaxed);
+        ShotLogCell* cell = &queue->cells[position & SHOT_LOG_QUEUE_MASK];
+        if (cell->sequence.load(std::memory_order_acquire) != position + 1) break;
+
+        // Only shots that reached the log join the library, under their position
+        matchShot(&cell->shot);
+        if (saveShotToFile(&cell->shot)) {
+            loggedShots++;
+            addToShotLibrary(&cell->shot, loggedShots);
+        }
+        cell->sequence.store(position + SHOT_LOG_QUEUE_CAPACITY, std::memory_order_release);
+        queue->head.store(position + 1, std::memory_order_relaxed);
+        written++;
+    }
+    return written;
+}
+
+static void shotLogLoop() {
+    setSpanThreadName("shot_logger");
+    loadShotLibrary();  // Off the start-up path; queued shots wait until it is built
+
+    // Back off while no shots come so an idle system rarely wakes
+    int interval = SHOT_LOG_DRAIN_INTERVAL;
+    std::unique_lock<std::mutex> guard(shotLogLock);
+    while (shotLogRunning) {
+        shotLogWake.wait_for(guard, std::chrono::milliseconds(interval));
+        guard.unlock();
+        if (drainShotLog(&shotLogQueue) > 0) {
+            interval = SHOT_LOG_DRAIN_INTERVAL;
+        } else {
+            interval = std::min(interval * 2, SHOT_LOG_IDLE_INTERVAL);
+        }
+        guard.lock();
+    }
+    guard.unlock();
+    drainShotLog(&shotLogQueue);
+}
+
+void initDataLogger() {
+    std::lock_guard<std::mutex> guard(shotLogLock);
+    if (shotLogRunning) return;
+    repairCorruptedData();
+    initShotLogQueue(&shotLogQueue);
+    shotLogRunning = true;
+    shotLogThread = std::thread(shotLogLoop);
+}
+
+void stopDataLogger() {
+    {
+        std::lock_guard<std::mutex> guard(shotLogLock);
+        if (!shotLogRunning) return;
+        shotLogRunning = false;
+    }
+    shotLogWake.notify_all();
+    shotLogThread.join();
+}
+
+bool validateShotData(const ShotData* shot) {
+    if (!std::isfinite(shot->peakAccel) || !std::isfinite(shot->formScore)) return false;
+    if (shot->formScore < 0 || shot->formScore > 100) return false;
+    if (shot->trajectory.size() > MAX_TRAJECTORY_POINTS) return false;
+
+    for (const Vector3D& point : shot->trajectory) {
+        if (!std::isfinite(point.x) || !std::isfinite(point.y) || !std::isfinite(point.z)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void repairCorruptedData() {
+    // Blocks are checksummed and append-only, so only the tail can be torn.
+    // Recovery reads backwards from the end instead of validating every shot.
+    LogRecoveryResult result;
+    if (!recoverLogFile(SHOT_LOG_FILE, &result)) {
+        return;  // No log yet
+    }
+
+    if (result.truncated) {
+        std::cout << "Recovered " << SHOT_LOG_FILE << ": dropped "
+                  << (result.fileSize - result.validSize) << " bytes of torn data" << std::endl;
+    }
+}
@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <cstdint>
 #include "sensors.h"
 
 // File Definitions
@@ -16,11 +17,17 @@ const std::string SHOT_DATA_FILE = "shot_data.csv";
 const std::string CALIBRATION_FILE = "calibration.dat";
 const std::string PERFORMANCE_FILE = "performance.csv";
 const std::string CONFIG_FILE = "config.txt";
+const std::string SHOT_LOG_FILE = "shot_data.log";  // Checksummed blocks, see log_block.h
+const std::string SESSION_FILE_EXTENSION = ".session";  // Raw sample recordings
 
 // Data Logging Configuration
 const int MAX_SHOTS_PER_SESSION = 100;
 const int MAX_TRAJECTORY_POINTS = 100;
 const int LOG_BUFFER_SIZE = 512;
+const int SESSION_SAMPLES_PER_BLOCK = 1024;
+const int SHOT_LOG_QUEUE_CAPACITY = 16;   // Shots waiting for the writer, power of two
+const int SHOT_LOG_DRAIN_INTERVAL = 50;   // ms between writer drains
+const int SHOT_LOG_IDLE_INTERVAL = 1000;  // ms; drains back off to this while no shots come
 
 // Performance Metrics
 struct PerformanceMetrics {
@@ -58,18 +65,15 @@ enum LoggingMode {
     LOG_BOTH
 };
 
-// Global Variables
-extern LoggingMode currentLoggingMode;
-extern PerformanceMetrics performanceMetrics;
-extern bool fileSystemAvailable;
-
 // Function Declarations
-void initDataLogger();
+void initDataLogger();  // Recovers the shot log's tail and starts its writer thread
+void stopDataLogger();  // Writes out the shots still queued
+bool queueShotForLogging(const ShotData* shot);  // Any thread, no allocation; false if the queue is full
 bool initFileSystem();
 void logShotData(const ShotData* shot);
 void logCalibrationData(const CalibrationData* data);
 void logPerformanceMetrics(const PerformanceMetrics* metrics);
-void saveShotToFile(const ShotData* shot);
+bool saveShotToFile(const ShotData* shot);
 void saveCalibrationToFile(const CalibrationData* data);
 void loadCalibrationFromFile(CalibrationData* data);
 void exportDataToCSV();
@@ -107,6 +111,16 @@ bool validateShotData(const ShotData* shot);
 bool validateCalibrationData(const CalibrationData* data);
 void repairCorruptedData();
 
+// Data Serialization Functions
+const uint8_t SHOT_RECORD_VERSION = 3;  // 3: outcome, 2: quantized trajectory (trajectory_quant.h)
+void serializeShotData(const ShotData* shot, std::vector<uint8_t>* out);
+bool deserializeShotData(const uint8_t* data, size_t length, ShotData* shot);
+
+// Session Recording Functions
+const uint8_t SESSION_RECORD_VERSION = 1;
+bool saveSessionRecording(const std::string& filename, const std::vector<MotionData>& samples);
+bool loadSessionRecording(const std::string& filename, std::vector<MotionData>* samples);
+
 // Memory Management
 void optimizeStorage();
 void compressOldData();
@@ -0,0 +1,159 @@
+/*
+ * Simulated DRV2605L Haptic Driver for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "drv2605.h"
+#include "metrics.h"
+#include "span_trace.h"
+#include "trace_log.h"
+#include <algorithm>
+
+struct EffectTiming {
+    uint8_t effect;
+    uint16_t ms;
+};
+
+static const EffectTiming EFFECT_TIMINGS[] = {
+    {DRV2605_STRONG_CLICK, 25},  {DRV2605_SHARP_CLICK, 20},    {DRV2605_SOFT_BUMP, 35},
+    {DRV2605_DOUBLE_CLICK, 120}, {DRV2605_TRIPLE_CLICK, 200},  {DRV2605_STRONG_BUZZ, 250},
+    {DRV2605_ALERT_750MS, 750},  {DRV2605_ALERT_1000MS, 1000}, {DRV2605_BUZZ, 300},
+    {DRV2605_RAMP_DOWN_LONG, 500}, {DRV2605_RAMP_UP_LONG, 500},
+};
+
+// Bus
+
+static bool validDevice(const Drv2605Array* array, int device) {
+    return array->bus && device >= 0 && device < array->deviceCount;
+}
+
+// The register cache follows what was queued, so a write the bus refused
+// is tried again by the next change
+static bool queueWrite(Drv2605Array* array, int device, uint8_t reg, const uint8_t* values, int count,
+                       I2cCallback done, void* context) {
+    if (!validDevice(array, device) || count <= 0 || reg + count > DRV2605_REGISTER_COUNT) return false;
+    const char* span = reg == DRV2605_REG_RTP_INPUT ? "drv2605_rtp" : "drv2605_write";
+    if (queueI2cWrite(array->bus, array->firstChannel + device, DRV2605_ADDRESS, reg, count, span, done, context) ==
+        I2C_REJECTED) {
+        return false;
+    }
+    std::copy(values, values + count, array->devices[device].registers + reg);
+    return true;
+}
+
+static bool writeRegister(Drv2605Array* array, int device, uint8_t reg, uint8_t value,
+                          I2cCallback done = nullptr, void* context = nullptr) {
+    return queueWrite(array, device, reg, &value, 1, done, context);
+}
+
+bool drv2605WriteRegisters(Drv2605Array* array, int device, uint8_t reg, const uint8_t* values, int count) {
+    return queueWrite(array, device, reg, values, count, nullptr, nullptr);
+}
+
+// Writes merged into this one reached the device with it
+static void recordActuation(const I2cTransaction* transaction, uint64_t outputNs) {
+    recordStageLatency(STAGE_HAPTIC_ACTUATION, outputNs - transaction->queuedNs);
+    for (int merged = 0; merged < transaction->merged; merged++) {
+        recordStageLatency(STAGE_HAPTIC_ACTUATION, outputNs - transaction->mergedNs[merged]);
+    }
+}
+
+static void onOutputWritten(I2cBus*, const I2cTransaction* transaction, uint64_t endNs) {
+    recordActuation(transaction, endNs);
+}
+
+static void onGoWritten(I2cBus*, const I2cTransaction* transaction, uint64_t endNs) {
+    Drv2605Device* device = static_cast<Drv2605Device*>(transaction->context);
+    device->goPending = false;
+    uint64_t playNs = endNs + DRV2605_GO_LATENCY_NS;
+    device->playEndNs = playNs + static_cast<uint64_t>(device->effectMs) * 1000000;
+    recordSpan("drv2605_go_latency", endNs, DRV2605_GO_LATENCY_NS);
+    recordSpan("drv2605_effect", playNs, device->playEndNs - playNs);
+    recordActuation(transaction, playNs);
+}
+
+// Leaving internal-trigger mode stops whatever effect is playing
+static void onRtpModeWritten(I2cBus*, const I2cTransaction* transaction, uint64_t endNs) {
+    Drv2605Device* device = static_cast<Drv2605Device*>(transaction->context);
+    device->playEndNs = std::min(device->playEndNs, endNs);
+}
+
+// Device
+
+int drv2605EffectMs(uint8_t effect) {
+    for (const EffectTiming& timing : EFFECT_TIMINGS) {
+        if (timing.effect == effect) return timing.ms;
+    }
+    return DRV2605_DEFAULT_EFFECT_MS;
+}
+
+void initDrv2605Array(Drv2605Array* array, I2cBus* bus, int devices, int firstChannel) {
+    array->bus = bus;
+    array->firstChannel = std::max(0, std::min(firstChannel, I2C_MUX_CHANNELS - 1));
+    array->deviceCount = std::max(0, std::min(devices, I2C_MUX_CHANNELS - array->firstChannel));
+    for (int device = 0; device < array->deviceCount; device++) {
+        array->devices[device] = Drv2605Device();
+        array->devices[device].registers[DRV2605_REG_MODE] = DRV2605_MODE_STANDBY;  // Power-on state
+
+        writeRegister(array, device, DRV2605_REG_MODE, DRV2605_MODE_INTERNAL_TRIGGER);
+        writeRegister(array, device, DRV2605_REG_FEEDBACK, DRV2605_FEEDBACK_LRA);
+        writeRegister(array, device, DRV2605_REG_LIBRARY, DRV2605_LIBRARY_LRA);
+        writeRegister(array, device, DRV2605_REG_CONTROL3, DRV2605_CONTROL3_RTP_UNSIGNED);
+        writeRegister(array, device, DRV2605_REG_MODE, DRV2605_MODE_RTP);
+    }
+}
+
+// A duty the device already holds costs nothing, so waveform ticks that
+// repeat a value stay off the bus; one still waiting for the bus is
+// overwritten in place. A zero duty for a device whose effect has ended
+// is silent already and leaves it in internal-trigger mode.
+bool drv2605SetDuty(Drv2605Array* array, int device, int duty) {
+    if (!validDevice(array, device)) return false;
+    Drv2605Device* state = &array->devices[device];
+    uint8_t* registers = state->registers;
+    uint8_t value = static_cast<uint8_t>(std::max(0, std::min(duty, 255)));
+    if (registers[DRV2605_REG_MODE] == DRV2605_MODE_RTP && registers[DRV2605_REG_RTP_INPUT] == value) {
+        return true;
+    }
+    if (registers[DRV2605_REG_MODE] == DRV2605_MODE_INTERNAL_TRIGGER && value == 0 &&
+        !drv2605Playing(array, device, traceTimestampNs())) {
+        return true;
+    }
+
+    if (registers[DRV2605_REG_MODE] != DRV2605_MODE_RTP &&
+        !writeRegister(array, device, DRV2605_REG_MODE, DRV2605_MODE_RTP, onRtpModeWritten, state)) {
+        return false;
+    }
+    return writeRegister(array, device, DRV2605_REG_RTP_INPUT, value, onOutputWritten);
+}
+
+bool drv2605PlayEffects(Drv2605Array* array, int device, const uint8_t* effects, int count) {
+    if (!validDevice(array, device) || count <= 0) return false;
+    count = std::min(count, DRV2605_WAVESEQ_LENGTH);
+
+    uint8_t sequence[DRV2605_WAVESEQ_LENGTH] = {};
+    int playMs = 0;
+    for (int i = 0; i < count; i++) {
+        sequence[i] = effects[i];
+        playMs += drv2605EffectMs(effects[i]);
+    }
+    int written = std::min(count + 1, DRV2605_WAVESEQ_LENGTH);  // With the terminating 0 if it fits
+
+    Drv2605Device* state = &array->devices[device];
+    if (state->registers[DRV2605_REG_MODE] != DRV2605_MODE_INTERNAL_TRIGGER &&
+        !writeRegister(array, device, DRV2605_REG_MODE, DRV2605_MODE_INTERNAL_TRIGGER)) {
+        return false;
+    }
+    if (!drv2605WriteRegisters(array, device, DRV2605_REG_WAVESEQ1, sequence, written)) return false;
+    state->effectMs = playMs;
+    state->goPending = true;
+    if (writeRegister(array, device, DRV2605_REG_GO, 1, onGoWritten, state)) return true;
+    state->goPending = false;
+    return false;
+}
+
+bool drv2605Playing(const Drv2605Array* array, int device, uint64_t nowNs) {
+    if (device < 0 || device >= array->deviceCount) return false;
+    const Drv2605Device& state = array->devices[device];
+    return state.goPending || nowNs < state.playEndNs;
+}
@@ -0,0 +1,93 @@
+/*
+ * Simulated DRV2605L Haptic Driver for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Stands in for one DRV2605L per motor, each on its own channel of the
+ * TCA9548A I2C mux (the DRV2605L has a fixed address). Register writes
+ * are queued on an I2cBus (i2c_bus.h), so the command path sees the bus
+ * costs real hardware would. Motor duty goes out as real-time playback
+ * (RTP) writes; library effects go out as a waveform sequence write, a GO
+ * write and the go-bit start-up latency. Switching back to RTP cuts an
+ * effect short, as on the device. Go latency and effect playback are
+ * recorded as spans, and request-to-output latency as the
+ * haptic_actuation stage. The haptic layer plays its pulse patterns as
+ * library clicks, with their waveform still running its thermal model,
+ * and falls back to RTP duty once a coil is warm enough to derate.
+ */
+
+#ifndef DRV2605_H
+#define DRV2605_H
+
+#include <cstdint>
+#include "i2c_bus.h"
+
+// Bus Configuration
+const int DRV2605_ADDRESS = 0x5A;
+const int DRV2605_MAX_DEVICES = I2C_MUX_CHANNELS;  // One per channel
+
+// Registers
+const uint8_t DRV2605_REG_STATUS = 0x00;
+const uint8_t DRV2605_REG_MODE = 0x01;
+const uint8_t DRV2605_REG_RTP_INPUT = 0x02;
+const uint8_t DRV2605_REG_LIBRARY = 0x03;
+const uint8_t DRV2605_REG_WAVESEQ1 = 0x04;  // Through 0x0B; a 0 ends the sequence
+const uint8_t DRV2605_REG_GO = 0x0C;
+const uint8_t DRV2605_REG_FEEDBACK = 0x1A;
+const uint8_t DRV2605_REG_CONTROL3 = 0x1D;
+const int DRV2605_REGISTER_COUNT = 0x23;
+const int DRV2605_WAVESEQ_LENGTH = 8;
+
+// Register Values
+const uint8_t DRV2605_MODE_INTERNAL_TRIGGER = 0x00;
+const uint8_t DRV2605_MODE_RTP = 0x05;
+const uint8_t DRV2605_MODE_STANDBY = 0x40;
+const uint8_t DRV2605_LIBRARY_LRA = 6;
+const uint8_t DRV2605_FEEDBACK_LRA = 0xB6;   // N_ERM_LRA set, default gains
+const uint8_t DRV2605_CONTROL3_RTP_UNSIGNED = 0xA8;
+
+// Timing Model
+const uint64_t DRV2605_GO_LATENCY_NS = 600000;  // GO written to drive starting, LRA resonance lock
+const int DRV2605_DEFAULT_EFFECT_MS = 100;      // Library effects missing from the table
+
+// Library effects used by the trainer (LRA library, approximate play times)
+enum Drv2605Effect : uint8_t {
+    DRV2605_STRONG_CLICK = 1,
+    DRV2605_SHARP_CLICK = 4,
+    DRV2605_SOFT_BUMP = 7,
+    DRV2605_DOUBLE_CLICK = 10,
+    DRV2605_TRIPLE_CLICK = 12,
+    DRV2605_STRONG_BUZZ = 14,
+    DRV2605_ALERT_750MS = 15,
+    DRV2605_ALERT_1000MS = 16,
+    DRV2605_BUZZ = 47,
+    DRV2605_RAMP_DOWN_LONG = 70,
+    DRV2605_RAMP_UP_LONG = 82
+};
+
+struct Drv2605Device {
+    uint8_t registers[DRV2605_REGISTER_COUNT];  // Last value queued
+    uint64_t playEndNs;                         // While GO is set
+    int effectMs;                               // Play time of the sequence waiting for its GO write
+    bool goPending;                             // GO queued, not yet on the bus
+
+    Drv2605Device() : registers(), playEndNs(0), effectMs(0), goPending(false) {}
+};
+
+struct Drv2605Array {
+    I2cBus* bus;
+    int firstChannel;  // Mux channel of device 0; the rest follow it
+    int deviceCount;
+    Drv2605Device devices[DRV2605_MAX_DEVICES];
+
+    Drv2605Array() : bus(nullptr), firstChannel(0), deviceCount(0), devices() {}
+};
+
+// Function Declarations
+int drv2605EffectMs(uint8_t effect);
+void initDrv2605Array(Drv2605Array* array, I2cBus* bus, int devices, int firstChannel);  // Configures each for LRA RTP
+bool drv2605WriteRegisters(Drv2605Array* array, int device, uint8_t reg, const uint8_t* values, int count);
+bool drv2605SetDuty(Drv2605Array* array, int device, int duty);  // RTP; stops an effect
+bool drv2605PlayEffects(Drv2605Array* array, int device, const uint8_t* effects, int count);
+bool drv2605Playing(const Drv2605Array* array, int device, uint64_t nowNs);  // Including a GO still queued
+
+#endif // DRV2605_H
@@ -0,0 +1,189 @@
+/*
+ * Fused Filter Pipeline for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Filter stages composed at compile time, e.g.
+ *   Pipeline<LowPass<std::ratio<1, 5>>, RemoveGravity, Kalman>
+ * process() runs every stage on one sample while it is in registers, and
+ * the sample spacing is worked out once for all of them. Stage constants
+ * are constexpr, so the compiler folds them into the single loop.
+ *
+ * Coefficients are specified at the nominal SAMPLE_RATE and rescaled by
+ * the actual timestamp spacing, so the output does not depend on the rate.
+ */
+
+#ifndef FILTER_PIPELINE_H
+#define FILTER_PIPELINE_H
+
+#include <cmath>
+#include <cstddef>
+#include <ratio>
+#include <tuple>
+#include <utility>
+#include "sensors.h"
+
+// Filter Constants
+constexpr double GRAVITY_TIME_CONSTANT = 0.5;      // seconds
+constexpr double GRAVITY_STILL_TOLERANCE = 0.1;    // g; gravity only tracked this close to 1g
+constexpr double KALMAN_ACCEL_PROCESS = 0.04;      // g^2 per second
+constexpr double KALMAN_ACCEL_MEASUREMENT = 1e-4;  // g^2
+constexpr double KALMAN_GYRO_PROCESS = 400.0;      // (deg/s)^2 per second
+constexpr double KALMAN_GYRO_MEASUREMENT = 1.0;    // (deg/s)^2
+
+// Seconds since the previous timestamp, or 0 for the first sample
+struct SampleClock {
+    unsigned long lastTimestamp;
+    bool primed;
+
+    SampleClock() : lastTimestamp(0), primed(false) {}
+
+    double advance(unsigned long timestamp) {
+        double seconds = primed ? (timestamp - lastTimestamp) / 1000000.0 : 0.0;
+        lastTimestamp = timestamp;
+        primed = true;
+        return seconds;
+    }
+};
+
+inline void blendVector(Vector3D* state, const Vector3D& sample, double alpha) {
+    state->x += alpha * (sample.x - state->x);
+    state->y += alpha * (sample.y - state->y);
+    state->z += alpha * (sample.z - state->z);
+}
+
+// Single-pole low-pass; alpha is the smoothing factor at SAMPLE_RATE
+struct LowPassFilter {
+    MotionData state;
+    bool primed;
+    double cachedAlpha, cachedSeconds, spacedAlpha;  // pow() only when the spacing changes
+
+    LowPassFilter() : primed(false), cachedAlpha(-1), cachedSeconds(-1), spacedAlpha(0) {}
+
+    void reset() { *this = LowPassFilter(); }
+
+    void apply(MotionData* sample, double alpha, double seconds) {
+        if (!primed) {
+            state = *sample;
+            primed = true;
+            return;
+        }
+        if (alpha != cachedAlpha || seconds != cachedSeconds) {
+            cachedAlpha = alpha;
+            cachedSeconds = seconds;
+            spacedAlpha = 1.0 - std::pow(1.0 - alpha, seconds * SAMPLE_RATE);
+        }
+        blendVector(&state.accel, sample->accel, spacedAlpha);
+        blendVector(&state.gyro, sample->gyro, spacedAlpha);
+        state.magnitude += spacedAlpha * (sample->magnitude - state.magnitude);
+        sample->accel = state.accel;
+        sample->gyro = state.gyro;
+        sample->magnitude = state.magnitude;
+    }
+};
+
+template <typename Alpha>
+struct LowPass : LowPassFilter {
+    static_assert(Alpha::num > 0 && Alpha::num <= Alpha::den, "alpha must be in (0, 1]");
+    static constexpr double alpha = static_cast<double>(Alpha::num) / Alpha::den;
+
+    void process(MotionData* sample, double seconds) { apply(sample, alpha, seconds); }
+};
+
+// Tracks gravity with a slow low-pass while the sensor is near still (so
+// sustained shot acceleration is not absorbed) and leaves linear
+// acceleration in accel
+struct RemoveGravity {
+    Vector3D gravity;
+    double cachedSeconds, spacedAlpha;
+
+    RemoveGravity() : gravity(0, 0, 1.0), cachedSeconds(-1), spacedAlpha(0) {}
+
+    void reset() { *this = RemoveGravity(); }
+
+    void process(MotionData* sample, double seconds) {
+        if (seconds != cachedSeconds) {
+            cachedSeconds = seconds;
+            spacedAlpha = 1.0 - std::exp(-seconds / GRAVITY_TIME_CONSTANT);
+        }
+        if (std::abs(vectorMagnitude(&sample->accel) - 1.0) < GRAVITY_STILL_TOLERANCE) {
+            blendVector(&gravity, sample->accel, spacedAlpha);
+        }
+        sample->accel.x -= gravity.x;
+        sample->accel.y -= gravity.y;
+        sample->accel.z -= gravity.z;
+        sample->magnitude = vectorMagnitude(&sample->accel);
+    }
+};
+
+// Random-walk Kalman filter per accel and gyro axis
+struct Kalman {
+    double estimate[6];
+    double variance[6];
+    bool primed;
+
+    Kalman() : estimate(), variance(), primed(false) {}
+
+    void reset() { *this = Kalman(); }
+
+    static double update(double* x, double* p, double measurement, double process, double noise) {
+        *p += process;
+        double gain = *p / (*p + noise);
+        *x += gain * (measurement - *x);
+        *p *= 1.0 - gain;
+        return *x;
+    }
+
+    void process(MotionData* sample, double seconds) {
+        double* axes[6] = {&sample->accel.x, &sample->accel.y, &sample->accel.z,
+                           &sample->gyro.x, &sample->gyro.y, &sample->gyro.z};
+        if (!primed) {
+            for (int i = 0; i < 6; i++) {
+                estimate[i] = *axes[i];
+                variance[i] = i < 3 ? KALMAN_ACCEL_MEASUREMENT : KALMAN_GYRO_MEASUREMENT;
+            }
+            primed = true;
+            return;
+        }
+        for (int i = 0; i < 3; i++) {
+            *axes[i] = update(&estimate[i], &variance[i], *axes[i],
+                              KALMAN_ACCEL_PROCESS * seconds, KALMAN_ACCEL_MEASUREMENT);
+        }
+        for (int i = 3; i < 6; i++) {
+            *axes[i] = update(&estimate[i], &variance[i], *axes[i],
+                              KALMAN_GYRO_PROCESS * seconds, KALMAN_GYRO_MEASUREMENT);
+        }
+    }
+};
+
+// Runs Stages in order on each sample
+template <typename... Stages>
+struct Pipeline {
+    std::tuple<Stages...> stages;
+    SampleClock clock;
+
+    void reset() {
+        clock = SampleClock();
+        std::apply([](Stages&... stage) { (stage.reset(), ...); }, stages);
+    }
+
+    void process(MotionData* sample) {
+        double seconds = clock.advance(sample->timestamp);
+        std::apply([sample, seconds](Stages&... stage) { (stage.process(sample, seconds), ...); }, stages);
+    }
+
+    void processBlock(MotionData* samples, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            process(&samples[i]);
+        }
+    }
+
+    template <size_t I>
+    typename std::tuple_element<I, std::tuple<Stages...>>::type& stage() {
+        return std::get<I>(stages);
+    }
+};
+
+// Default chain for the sensor path
+typedef Pipeline<LowPass<std::ratio<1, 2>>, RemoveGravity, Kalman> MotionFilterPipeline;
+
+#endif // FILTER_PIPELINE_H
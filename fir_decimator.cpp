@@ -0,0 +1,128 @@
+/*
+ * Polyphase FIR Decimation for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "fir_decimator.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+const double PI = 3.14159265358979323846;
+
+bool initFirDecimator(FirDecimator* decimator, int ratio, double inputRate, double cutoff,
+                      int tapsPerPhase) {
+    if (ratio < 1 || tapsPerPhase < 1 || inputRate <= 0 || cutoff <= 0 || cutoff >= inputRate / 2) {
+        return false;
+    }
+
+    // Blackman-windowed sinc, normalized to unity gain at DC
+    int length = ratio * tapsPerPhase;
+    double normalizedCutoff = cutoff / inputRate;
+    double centre = (length - 1) / 2.0;
+    double span = length > 1 ? length - 1 : 1;
+    std::vector<double> prototype(length);
+    double sum = 0;
+    for (int k = 0; k < length; k++) {
+        double t = k - centre;
+        double sinc = t == 0 ? 2.0 * normalizedCutoff
+                             : std::sin(2.0 * PI * normalizedCutoff * t) / (PI * t);
+        double window = 0.42 - 0.5 * std::cos(2.0 * PI * k / span) + 0.08 * std::cos(4.0 * PI * k / span);
+        prototype[k] = sinc * window;
+        sum += prototype[k];
+    }
+
+    // Branch p holds h[p], h[p + ratio], h[p + 2 * ratio], ...
+    *decimator = FirDecimator();
+    decimator->ratio = ratio;
+    decimator->phaseTaps = tapsPerPhase;
+    decimator->taps.resize(length);
+    for (int phase = 0; phase < ratio; phase++) {
+        for (int j = 0; j < tapsPerPhase; j++) {
+            decimator->taps[phase * tapsPerPhase + j] = static_cast<float>(prototype[phase + j * ratio] / sum);
+        }
+    }
+    decimator->pending.assign(static_cast<size_t>(tapsPerPhase) * FIR_CHANNELS, 0.0f);
+    return true;
+}
+
+void resetFirDecimator(FirDecimator* decimator) {
+    std::fill(decimator->pending.begin(), decimator->pending.end(), 0.0f);
+    decimator->nextOutput = 0;
+    decimator->inputCount = 0;
+    decimator->lastTimestamp = 0;
+    decimator->inputSpacing = 0;
+}
+
+// pending[slot] += coefficient * frame, all channels at once
+static inline void accumulateFrame(float* slot, float coefficient, const float* frame) {
+#if defined(__SSE2__)
+    __m128 c = _mm_set1_ps(coefficient);
+    _mm_storeu_ps(slot, _mm_add_ps(_mm_loadu_ps(slot), _mm_mul_ps(c, _mm_loadu_ps(frame))));
+    _mm_storeu_ps(slot + 4, _mm_add_ps(_mm_loadu_ps(slot + 4), _mm_mul_ps(c, _mm_loadu_ps(frame + 4))));
+#else
+    for (int channel = 0; channel < FIR_CHANNELS; channel++) {
+        slot[channel] += coefficient * frame[channel];
+    }
+#endif
+}
+
+bool decimateSample(FirDecimator* decimator, const MotionData* input, MotionData* output) {
+    float frame[FIR_CHANNELS] = {
+        static_cast<float>(input->accel.x), static_cast<float>(input->accel.y),
+        static_cast<float>(input->accel.z), static_cast<float>(input->gyro.x),
+        static_cast<float>(input->gyro.y), static_cast<float>(input->gyro.z),
+        static_cast<float>(input->magnitude), 0.0f,
+    };
+
+    // Output m is sum(h[k] * x[m * ratio - k]); this input is k = phase for
+    // the next pending output and phase + j * ratio for the ones after it
+    int ratio = decimator->ratio;
+    size_t phaseTaps = decimator->phaseTaps;
+    int phase = static_cast<int>((ratio - decimator->inputCount % ratio) % ratio);
+    const float* branch = &decimator->taps[phase * phaseTaps];
+    float* pending = decimator->pending.data();
+    size_t first = decimator->nextOutput;
+    for (size_t j = 0; j < phaseTaps - first; j++) {
+        accumulateFrame(pending + (first + j) * FIR_CHANNELS, branch[j], frame);
+    }
+    for (size_t j = phaseTaps - first; j < phaseTaps; j++) {
+        accumulateFrame(pending + (first + j - phaseTaps) * FIR_CHANNELS, branch[j], frame);
+    }
+
+    if (decimator->inputCount > 0) {
+        decimator->inputSpacing = input->timestamp - decimator->lastTimestamp;
+    }
+    decimator->lastTimestamp = input->timestamp;
+    decimator->inputCount++;
+    if (phase != 0) return false;
+
+    // Output complete: emit it and recycle the slot for the furthest output
+    float* done = pending + first * FIR_CHANNELS;
+    unsigned long delay = decimator->inputSpacing * (ratio * phaseTaps - 1) / 2;
+    *output = MotionData();
+    output->accel = Vector3D(done[0], done[1], done[2]);
+    output->gyro = Vector3D(done[3], done[4], done[5]);
+    output->magnitude = done[6];
+    output->timestamp = input->timestamp > delay ? input->timestamp - delay : 0;
+    std::fill(done, done + FIR_CHANNELS, 0.0f);
+    decimator->nextOutput = (first + 1) % phaseTaps;
+    return true;
+}
+
+size_t decimateBlock(FirDecimator* decimator, const MotionData* input, size_t count,
+                     std::vector<MotionData>* output) {
+    size_t produced = 0;
+    output->reserve(output->size() + count / decimator->ratio + 1);
+    MotionData sample;
+    for (size_t i = 0; i < count; i++) {
+        if (decimateSample(decimator, &input[i], &sample)) {
+            output->push_back(sample);
+            produced++;
+        }
+    }
+    return produced;
+}
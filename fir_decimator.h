@@ -0,0 +1,47 @@
+/*
+ * Polyphase FIR Decimation for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Anti-aliased rate reduction for high-rate IMU streams (e.g. 1 kHz down
+ * to SAMPLE_RATE for scoring). The windowed-sinc filter is split into
+ * `ratio` polyphase branches, so each input sample costs taps/ratio
+ * multiply-adds per channel, and all channels of a sample are processed
+ * together in SIMD lanes.
+ */
+
+#ifndef FIR_DECIMATOR_H
+#define FIR_DECIMATOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "sensors.h"
+
+// Decimator Configuration
+const int FIR_CHANNELS = 8;          // accel xyz, gyro xyz, magnitude, padding
+const int FIR_TAPS_PER_PHASE = 8;    // Filter length is ratio * this
+const double FIR_DEFAULT_CUTOFF = 0.4;  // Fraction of the output sample rate
+
+struct FirDecimator {
+    int ratio;
+    int phaseTaps;               // Taps per polyphase branch
+    std::vector<float> taps;     // ratio * phaseTaps coefficients
+    std::vector<float> pending;  // phaseTaps partial outputs x FIR_CHANNELS
+    size_t nextOutput;           // Slot in pending completed next
+    uint64_t inputCount;
+    unsigned long lastTimestamp;
+    unsigned long inputSpacing;  // Microseconds, for the group delay
+
+    FirDecimator() : ratio(1), phaseTaps(0), nextOutput(0), inputCount(0),
+                     lastTimestamp(0), inputSpacing(0) {}
+};
+
+// Function Declarations
+bool initFirDecimator(FirDecimator* decimator, int ratio, double inputRate, double cutoff,
+                      int tapsPerPhase = FIR_TAPS_PER_PHASE);
+void resetFirDecimator(FirDecimator* decimator);
+bool decimateSample(FirDecimator* decimator, const MotionData* input, MotionData* output);
+size_t decimateBlock(FirDecimator* decimator, const MotionData* input, size_t count,
+                     std::vector<MotionData>* output);
+
+#endif // FIR_DECIMATOR_H
@@ -0,0 +1,330 @@
+/*
+ * Median/MAD Spike Rejection for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "hampel_filter.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+const int SKIPLIST_HEAD = 0;
+const int SKIPLIST_TAIL = 1;
+const double MAD_TO_STDDEV = 1.4826;  // For normally distributed noise
+const int HAMPEL_MIN_SAMPLES = 3;     // Fewer cannot out-vote a spike
+
+// Skiplist
+//
+// Indexable skiplist after R. Hettinger's running-median recipe: every link
+// stores how many ranks it skips, so rank lookups descend like searches.
+
+void initSkiplist(IndexableSkiplist* list, int capacity) {
+    *list = IndexableSkiplist();
+    while ((1 << list->levels) < capacity && list->levels < SKIPLIST_MAX_LEVEL) {
+        list->levels++;
+    }
+
+    list->nodes.resize(capacity + 2);
+    for (int index : {SKIPLIST_HEAD, SKIPLIST_TAIL}) {
+        SkiplistNode& node = list->nodes[index];
+        node.value = index == SKIPLIST_HEAD ? -std::numeric_limits<double>::infinity()
+                                            : std::numeric_limits<double>::infinity();
+        node.levels = SKIPLIST_MAX_LEVEL;
+        for (int level = 0; level < SKIPLIST_MAX_LEVEL; level++) {
+            node.next[level] = SKIPLIST_TAIL;
+            node.width[level] = 1;
+        }
+    }
+    for (int index = capacity + 1; index > SKIPLIST_TAIL; index--) {
+        list->freeNodes.push_back(index);
+    }
+}
+
+// Geometric level: each extra level with probability 1/2
+static int randomLevel(IndexableSkiplist* list) {
+    uint32_t bits = list->levelSeed;
+    bits ^= bits << 13;
+    bits ^= bits >> 17;
+    bits ^= bits << 5;
+    list->levelSeed = bits;
+
+    int level = 1;
+    while (level < list->levels && (bits & 1)) {
+        level++;
+        bits >>= 1;
+    }
+    return level;
+}
+
+void skiplistInsert(IndexableSkiplist* list, double value) {
+    int chain[SKIPLIST_MAX_LEVEL];
+    int stepsAtLevel[SKIPLIST_MAX_LEVEL];
+    std::vector<SkiplistNode>& nodes = list->nodes;
+
+    int node = SKIPLIST_HEAD;
+    for (int level = list->levels - 1; level >= 0; level--) {
+        stepsAtLevel[level] = 0;
+        while (nodes[nodes[node].next[level]].value <= value) {
+            stepsAtLevel[level] += nodes[node].width[level];
+            node = nodes[node].next[level];
+        }
+        chain[level] = node;
+    }
+
+    if (list->freeNodes.empty()) {
+        list->freeNodes.push_back(static_cast<int>(nodes.size()));
+        nodes.push_back(SkiplistNode());
+    }
+    int inserted = list->freeNodes.back();
+    list->freeNodes.pop_back();
+    SkiplistNode& fresh = nodes[inserted];
+    fresh.value = value;
+    fresh.levels = randomLevel(list);
+
+    int steps = 0;
+    for (int level = 0; level < fresh.levels; level++) {
+        SkiplistNode& previous = nodes[chain[level]];
+        fresh.next[level] = previous.next[level];
+        previous.next[level] = inserted;
+        fresh.width[level] = previous.width[level] - steps;
+        previous.width[level] = steps + 1;
+        steps += stepsAtLevel[level];
+    }
+    for (int level = fresh.levels; level < list->levels; level++) {
+        nodes[chain[level]].width[level]++;
+    }
+    list->size++;
+}
+
+bool skiplistRemove(IndexableSkiplist* list, double value) {
+    int chain[SKIPLIST_MAX_LEVEL];
+    std::vector<SkiplistNode>& nodes = list->nodes;
+
+    int node = SKIPLIST_HEAD;
+    for (int level = list->levels - 1; level >= 0; level--) {
+        while (nodes[nodes[node].next[level]].value < value) {
+            node = nodes[node].next[level];
+        }
+        chain[level] = node;
+    }
+
+    int removed = nodes[chain[0]].next[0];
+    if (removed == SKIPLIST_TAIL || nodes[removed].value != value) return false;
+
+    for (int level = 0; level < nodes[removed].levels; level++) {
+        SkiplistNode& previous = nodes[chain[level]];
+        previous.width[level] += nodes[removed].width[level] - 1;
+        previous.next[level] = nodes[removed].next[level];
+    }
+    for (int level = nodes[removed].levels; level < list->levels; level++) {
+        nodes[chain[level]].width[level]--;
+    }
+    list->freeNodes.push_back(removed);
+    list->size--;
+    return true;
+}
+
+double skiplistAt(const IndexableSkiplist* list, int rank) {
+    const std::vector<SkiplistNode>& nodes = list->nodes;
+    int node = SKIPLIST_HEAD;
+    int remaining = rank + 1;
+    for (int level = list->levels - 1; level >= 0; level--) {
+        while (nodes[node].width[level] <= remaining) {
+            remaining -= nodes[node].width[level];
+            node = nodes[node].next[level];
+        }
+    }
+    return nodes[node].value;
+}
+
+// Hampel Filter
+
+static double* channelValue(MotionData* sample, int channel) {
+    switch (channel) {
+        case 0: return &sample->accel.x;
+        case 1: return &sample->accel.y;
+        case 2: return &sample->accel.z;
+        case 3: return &sample->gyro.x;
+        case 4: return &sample->gyro.y;
+        case 5: return &sample->gyro.z;
+        default: return &sample->magnitude;
+    }
+}
+
+static double channelFloor(int channel) {
+    return channel >= 3 && channel < 6 ? HAMPEL_GYRO_FLOOR : HAMPEL_ACCEL_FLOOR;
+}
+
+// Median of |x - median| as the k-th smallest of two ascending runs: the
+// distances walking down from the middle and walking up from it
+static double medianAbsoluteDeviation(const IndexableSkiplist* list, double median) {
+    int n = list->size;
+    int mid = (n - 1) / 2;
+    int lengthA = mid + 1;
+    int lengthB = n - mid - 1;
+    int k = (n - 1) / 2;
+    auto a = [&](int i) { return median - skiplistAt(list, mid - i); };
+    auto b = [&](int j) { return skiplistAt(list, mid + 1 + j) - median; };
+
+    // Find how many of the k + 1 smallest come from run A
+    int low = std::max(0, k + 1 - lengthB);
+    int high = std::min(k + 1, lengthA);
+    while (low < high) {
+        int i = (low + high) / 2;
+        int j = k + 1 - i;
+        if (i < lengthA && j > 0 && a(i) < b(j - 1)) {
+            low = i + 1;
+        } else {
+            high = i;
+        }
+    }
+    int j = k + 1 - low;
+    double fromA = low > 0 ? a(low - 1) : 0.0;
+    double fromB = j > 0 ? b(j - 1) : 0.0;
+    return std::max(fromA, fromB);
+}
+
+static double windowMedian(const IndexableSkiplist* list) {
+    int n = list->size;
+    int mid = (n - 1) / 2;
+    return (n & 1) ? skiplistAt(list, mid) : (skiplistAt(list, mid) + skiplistAt(list, mid + 1)) / 2.0;
+}
+
+// True if value should be replaced; median is filled in either way
+static bool isOutlier(const IndexableSkiplist* list, double value, double threshold, double floor,
+                      double* median) {
+    *median = windowMedian(list);
+    double deviation = std::abs(value - *median);
+    if (list->size < HAMPEL_MIN_SAMPLES || deviation <= floor) return false;
+    return deviation > std::max(threshold * MAD_TO_STDDEV * medianAbsoluteDeviation(list, *median), floor);
+}
+
+bool initHampelFilter(HampelFilter* filter, int window, double threshold) {
+    if (window < HAMPEL_MIN_SAMPLES || window > HAMPEL_MAX_WINDOW || threshold <= 0) return false;
+
+    filter->window = window;
+    filter->threshold = threshold;
+    filter->recent.assign(window, MotionData());
+    filter->filled = 0;
+    filter->head = 0;
+    std::fill(std::begin(filter->lastValue), std::end(filter->lastValue), 0.0);
+    filter->samples = 0;
+    filter->emitted = 0;
+    filter->replaced = 0;
+    for (int channel = 0; channel < HAMPEL_CHANNELS; channel++) {
+        initSkiplist(&filter->sorted[channel], window);
+    }
+    return true;
+}
+
+// Tests every channel of a sample against the current window
+static void replaceOutliers(HampelFilter* filter, MotionData* output) {
+    for (int channel = 0; channel < HAMPEL_CHANNELS; channel++) {
+        double* value = channelValue(output, channel);
+        double median;
+        if (isOutlier(&filter->sorted[channel], *value, filter->threshold, channelFloor(channel), &median)) {
+            *value = median;
+            filter->replaced++;
+        }
+    }
+}
+
+static void removeFromWindow(HampelFilter* filter, MotionData* sample) {
+    for (int channel = 0; channel < HAMPEL_CHANNELS; channel++) {
+        skiplistRemove(&filter->sorted[channel], *channelValue(sample, channel));
+    }
+    filter->filled--;
+}
+
+bool hampelFilterSample(HampelFilter* filter, const MotionData* input, MotionData* output) {
+    size_t window = filter->window;
+    size_t half = window / 2;
+    MotionData& slot = filter->recent[filter->head];
+    if (filter->filled == window) removeFromWindow(filter, &slot);
+
+    slot = *input;
+    for (int channel = 0; channel < HAMPEL_CHANNELS; channel++) {
+        double* value = channelValue(&slot, channel);
+        if (!std::isfinite(*value)) *value = filter->lastValue[channel];
+        filter->lastValue[channel] = *value;
+        skiplistInsert(&filter->sorted[channel], *value);
+    }
+    filter->head = (filter->head + 1) % window;
+    filter->filled++;
+    filter->samples++;
+
+    // Test the sample half a window back, once its later neighbours are in
+    if (filter->samples <= half) return false;
+    *output = filter->recent[(filter->head + window - 1 - half) % window];
+    replaceOutliers(filter, output);
+    filter->emitted++;
+    return true;
+}
+
+// Sample k sits in recent[k % window]. Each held-back sample is tested
+// against the window [k - half, last sample], so older samples leave it
+// one by one; once all are out, the filter is empty again.
+bool hampelFilterFlush(HampelFilter* filter, MotionData* output) {
+    size_t window = filter->window;
+    size_t half = window / 2;
+    uint64_t oldest = filter->samples - filter->filled;
+    if (filter->emitted == filter->samples) {
+        for (; oldest < filter->samples; oldest++) {
+            removeFromWindow(filter, &filter->recent[oldest % window]);
+        }
+        filter->head = 0;
+        std::fill(std::begin(filter->lastValue), std::end(filter->lastValue), 0.0);
+        filter->samples = 0;
+        filter->emitted = 0;
+        return false;
+    }
+
+    uint64_t next = filter->emitted;
+    for (; oldest + half < next; oldest++) {
+        removeFromWindow(filter, &filter->recent[oldest % window]);
+    }
+    *output = filter->recent[next % window];
+    replaceOutliers(filter, output);
+    filter->emitted++;
+    return true;
+}
+
+size_t hampelFilterBatch(std::vector<MotionData>* samples, int window, double threshold) {
+    if (window < HAMPEL_MIN_SAMPLES || window > HAMPEL_MAX_WINDOW || threshold <= 0) return 0;
+
+    size_t count = samples->size();
+    size_t half = window / 2;
+    std::vector<double> raw(count);
+    IndexableSkiplist sorted;
+    size_t replaced = 0;
+
+    for (int channel = 0; channel < HAMPEL_CHANNELS; channel++) {
+        double last = 0.0;
+        for (size_t i = 0; i < count; i++) {
+            double value = *channelValue(&(*samples)[i], channel);
+            raw[i] = std::isfinite(value) ? value : last;
+            last = raw[i];
+        }
+
+        // Window [i - half, i + half], clipped at the ends of the recording
+        initSkiplist(&sorted, window);
+        for (size_t i = 0; i < std::min(half, count); i++) {
+            skiplistInsert(&sorted, raw[i]);
+        }
+        double floor = channelFloor(channel);
+        for (size_t i = 0; i < count; i++) {
+            if (i + half < count) skiplistInsert(&sorted, raw[i + half]);
+            if (i > half) skiplistRemove(&sorted, raw[i - half - 1]);
+
+            double median;
+            double* value = channelValue(&(*samples)[i], channel);
+            if (isOutlier(&sorted, raw[i], threshold, floor, &median)) {
+                *value = median;
+                replaced++;
+            } else {
+                *value = raw[i];
+            }
+        }
+    }
+    return replaced;
+}
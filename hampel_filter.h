@@ -0,0 +1,81 @@
+/*
+ * Median/MAD Spike Rejection for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Hampel filter per channel: a sample further than HAMPEL_THRESHOLD robust
+ * standard deviations (1.4826 * MAD) from the median of the window centred
+ * on it is replaced by the median, so streaming mode emits each sample
+ * window / 2 samples late; a flush emits the held-back tail with the
+ * window clipped at the end, as batch mode does. Non-finite values are
+ * replaced by the channel's previous value (0 at the start) in both
+ * modes, so they produce the same output. Windows are kept in indexable skiplists: a
+ * sample costs O(log w) to slide in and to read the median, and the MAD
+ * is only computed (O(log^2 w)) for samples that are not obvious inliers.
+ */
+
+#ifndef HAMPEL_FILTER_H
+#define HAMPEL_FILTER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "sensors.h"
+
+// Hampel Configuration
+const int HAMPEL_WINDOW = 7;              // Samples; odd keeps the median exact
+const int HAMPEL_MAX_WINDOW = 1023;
+const double HAMPEL_THRESHOLD = 3.0;      // Robust standard deviations
+const double HAMPEL_ACCEL_FLOOR = 0.05;   // g; deviations below this always pass
+const double HAMPEL_GYRO_FLOOR = 5.0;     // deg/s
+const int HAMPEL_CHANNELS = 7;            // accel xyz, gyro xyz, magnitude
+const int SKIPLIST_MAX_LEVEL = 10;
+
+// Sorted multiset with O(log n) insert, remove and rank lookup.
+// Nodes live in a fixed pool sized at init, so sliding never allocates.
+struct SkiplistNode {
+    double value;
+    int levels;
+    int next[SKIPLIST_MAX_LEVEL];
+    int width[SKIPLIST_MAX_LEVEL];  // Ranks skipped by next[level]
+};
+
+struct IndexableSkiplist {
+    std::vector<SkiplistNode> nodes;  // [0] head, [1] +infinity tail
+    std::vector<int> freeNodes;
+    int levels;
+    int size;
+    uint32_t levelSeed;
+
+    IndexableSkiplist() : levels(1), size(0), levelSeed(0x9E3779B9u) {}
+};
+
+struct HampelFilter {
+    int window;
+    double threshold;
+    std::vector<MotionData> recent;  // Ring of the last `window` raw samples
+    size_t filled;
+    size_t head;
+    IndexableSkiplist sorted[HAMPEL_CHANNELS];
+    double lastValue[HAMPEL_CHANNELS];  // Stands in for a non-finite value
+    uint64_t samples;   // Input since the last flush
+    uint64_t emitted;   // Output since the last flush
+    uint64_t replaced;  // Channel values replaced by the median
+
+    HampelFilter() : window(0), threshold(0), filled(0), head(0), lastValue(), samples(0), emitted(0),
+                     replaced(0) {}
+};
+
+// Skiplist Functions
+void initSkiplist(IndexableSkiplist* list, int capacity);
+void skiplistInsert(IndexableSkiplist* list, double value);
+bool skiplistRemove(IndexableSkiplist* list, double value);
+double skiplistAt(const IndexableSkiplist* list, int rank);
+
+// Hampel Functions
+bool initHampelFilter(HampelFilter* filter, int window = HAMPEL_WINDOW, double threshold = HAMPEL_THRESHOLD);
+bool hampelFilterSample(HampelFilter* filter, const MotionData* input, MotionData* output);  // Streaming
+bool hampelFilterFlush(HampelFilter* filter, MotionData* output);  // Call until false, then start afresh
+size_t hampelFilterBatch(std::vector<MotionData>* samples, int window = HAMPEL_WINDOW,
+                         double threshold = HAMPEL_THRESHOLD);  // In place
+
+#endif // HAMPEL_FILTER_H
@@ -0,0 +1,640 @@
+/*
+ * Haptic Feedback Control for Basketball Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "haptic.h"
+#include "haptic_waveforms.h"
+#include "trace_log.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+static HapticSequence hapticCues[HAPTIC_CUE_COUNT];  // Read-only once loaded, so shared by every trainer
+
+static thread_local HapticMotorTable* currentMotors = nullptr;  // Set by bindHapticMotors()
+static thread_local TimerWheel* currentWheel = nullptr;
+static thread_local uint32_t lastSequenceRun = 0;
+static thread_local bool releasingRuns = false;
+static thread_local bool releaseAgain = false;
+
+static unsigned long hapticNow() {
+    return static_cast<unsigned long>(traceTimestampNs() / 1000000);
+}
+
+static int lowestMotor(uint32_t mask) {
+    return __builtin_ctz(mask);
+}
+
+static void setMask(uint32_t* mask, int index, bool set) {
+    *mask = set ? *mask | (1u << index) : *mask & ~(1u << index);
+}
+
+static bool validMotor(const HapticMotorTable* table, int index) {
+    return index >= 0 && index < table->count;
+}
+
+// Thermal Model
+
+// Brings the coil temperature up to `now` under the duty applied since
+// the last update. Exact for a constant duty, so a gap of any length
+// costs one exp().
+static void advanceThermalModel(HapticMotorTable* table, int index, unsigned long now) {
+    if (now <= table->thermalTime[index]) return;
+    float target = HAPTIC_FULL_DRIVE_RISE * table->currentIntensity[index] / 255.0f;
+    float decay = std::exp(-static_cast<float>(now - table->thermalTime[index]) / HAPTIC_THERMAL_TIME_CONSTANT);
+    table->temperature[index] = target + (table->temperature[index] - target) * decay;
+    table->thermalTime[index] = now;
+}
+
+static void thermalTickTimer(TimerWheel* wheel, void* context);
+static void stopMotor(TimerWheel* wheel, HapticMotorTable* table, int index);
+static void thermalShutdown(TimerWheel* wheel, HapticMotorTable* table);
+
+// Every duty change goes through here, so the model always knows the duty
+// it integrates and the new duty is derated for the coil's heat. Driven
+// motors also re-derate every HAPTIC_THERMAL_TICK while a duty is held.
+static void driveMotor(TimerWheel* wheel, HapticMotorTable* table, int index, int duty) {
+    float before = hapticDerating(table->temperature[index]);
+    advanceThermalModel(table, index, static_cast<unsigned long>(wheel->now));
+    float derating = hapticDerating(table->temperature[index]);
+    if (duty > 0 && derating < 1.0f && (before >= 1.0f || table->drive[index] == 0)) {
+        traceLog(TRACE_HAPTIC_DERATING, table->pin[index], table->temperature[index], 100.0f * derating);
+    }
+
+    table->drive[index] = duty;
+    table->currentIntensity[index] = static_cast<int>(duty * derating);
+    bool effect = table->effectMask >> index & 1;  // The driver plays it; RTP would cut it short
+    if (table->driver && !effect) drv2605SetDuty(table->driver, index, table->currentIntensity[index]);
+    setMask(&table->drivenMask, index, duty > 0);
+    if (duty > 0 && table->thermalTimer[index] == 0) {
+        table->thermalTimer[index] =
+            schedulePeriodicTimer(wheel, HAPTIC_THERMAL_TICK, thermalTickTimer, &table->ref[index]);
+    } else if (duty == 0 && table->thermalTimer[index] != 0) {
+        cancelTimer(wheel, table->thermalTimer[index]);
+        table->thermalTimer[index] = 0;
+    }
+}
+
+static void thermalTickTimer(TimerWheel* wheel, void* context) {
+    HapticMotorRef* ref = static_cast<HapticMotorRef*>(context);
+    HapticMotorTable* table = ref->table;
+    driveMotor(wheel, table, ref->index, table->drive[ref->index]);
+    if (table->temperature[ref->index] >= HAPTIC_TEMPERATURE_LIMIT) thermalShutdown(wheel, table);
+}
+
+static void scheduleCooldown(TimerWheel* wheel, HapticMotorTable* table);
+
+static void cooldownTimer(TimerWheel* wheel, void* context) {
+    HapticMotorTable* table = static_cast<HapticMotorTable*>(context);
+    table->cooldownTimer = 0;
+    scheduleCooldown(wheel, table);
+}
+
+// Every motor is off after a shutdown, so each coil decays exponentially
+// from its last temperature: one timer for when the hottest crosses
+// HAPTIC_DERATE_START, then feedback resumes
+static void scheduleCooldown(TimerWheel* wheel, HapticMotorTable* table) {
+    unsigned long now = static_cast<unsigned long>(wheel->now);
+    float hottest = 0.0f;
+    for (int index = 0; index < table->count; index++) {
+        advanceThermalModel(table, index, now);
+        hottest = std::max(hottest, table->temperature[index]);
+    }
+    if (hottest < HAPTIC_DERATE_START) {
+        table->overheated = false;
+        traceLog(TRACE_HAPTIC_RESUMED, HAPTIC_DERATE_START);
+        return;
+    }
+    unsigned long delay =
+        static_cast<unsigned long>(std::ceil(HAPTIC_THERMAL_TIME_CONSTANT * std::log(hottest / HAPTIC_DERATE_START))) + 1;
+    table->cooldownTimer = scheduleTimer(wheel, delay, cooldownTimer, table);
+}
+
+// Stops only this table's motors and locks it out until they cool
+static void thermalShutdown(TimerWheel* wheel, HapticMotorTable* table) {
+    for (uint32_t mask = table->activeMask; mask; mask &= mask - 1) {
+        int index = lowestMotor(mask);
+        traceLog(TRACE_HAPTIC_EMERGENCY_STOP, table->pin[index], table->temperature[index]);
+    }
+    table->overheated = true;
+    for (uint32_t mask = table->activeMask | table->drivenMask; mask; mask &= mask - 1) {
+        stopMotor(wheel, table, lowestMotor(mask));
+    }
+    if (table->cooldownTimer == 0) scheduleCooldown(wheel, table);
+}
+
+// A lockout whose cooldown timer found the wheel full is retried on the
+// next request
+static bool hapticEnabled(TimerWheel* wheel, HapticMotorTable* table) {
+    if (table->overheated && table->cooldownTimer == 0) scheduleCooldown(wheel, table);
+    return table->enabled && !table->overheated;
+}
+
+// Motor Timers
+
+static void releaseSyncedRuns(TimerWheel* wheel, HapticMotorTable* table);
+
+static void stopMotor(TimerWheel* wheel, HapticMotorTable* table, int index) {
+    cancelTimer(wheel, table->timer[index]);
+    table->timer[index] = 0;
+    setMask(&table->activeMask, index, false);
+    setMask(&table->effectMask, index, false);  // An effect still playing is stopped by the RTP write
+    driveMotor(wheel, table, index, 0);
+    table->pattern[index] = NONE;
+    table->priority[index] = HAPTIC_PRIORITY_CONFIRMATION;
+    if (table->program[index].sequence) {
+        table->program[index] = HapticProgram();
+        releaseSyncedRuns(wheel, table);  // The rest of its run may have been waiting on it
+    }
+}
+
+// Marks a motor as playing, from `startTime`
+static void startMotor(HapticMotorTable* table, int index, int intensity, unsigned long startTime) {
+    table->patternIntensity[index] = std::max(0, std::min(intensity, 255));
+    table->startTime[index] = startTime;
+    setMask(&table->activeMask, index, true);
+}
+
+static void motorOffTimer(TimerWheel* wheel, void* context) {
+    HapticMotorRef* ref = static_cast<HapticMotorRef*>(context);
+    ref->table->timer[ref->index] = 0;
+    stopMotor(wheel, ref->table, ref->index);
+}
+
+// One waveform lookup per millisecond while a pattern plays
+static void patternTickTimer(TimerWheel* wheel, void* context) {
+    HapticMotorRef* ref = static_cast<HapticMotorRef*>(context);
+    HapticMotorTable* table = ref->table;
+    int index = ref->index;
+    int ms = static_cast<int>(wheel->now - table->startTime[index]);
+    if (ms >= static_cast<int>(table->duration[index])) {
+        stopMotor(wheel, table, index);
+        return;
+    }
+    driveMotor(wheel, table, index, waveformDuty(table->pattern[index], table->patternIntensity[index], ms));
+}
+
+// Library effect standing in for a pulse pattern, 0 for none
+static uint8_t patternEffect(HapticPattern pattern, int intensity) {
+    switch (pattern) {
+        case SINGLE_PULSE:
+            if (intensity >= STRONG) return DRV2605_STRONG_CLICK;
+            return intensity >= MEDIUM ? DRV2605_SHARP_CLICK : DRV2605_SOFT_BUMP;
+        case DOUBLE_PULSE: return DRV2605_DOUBLE_CLICK;
+        case TRIPLE_PULSE: return DRV2605_TRIPLE_CLICK;
+        default: return 0;
+    }
+}
+
+// Effects play at the library's amplitude, so only a coil cool enough
+// for full duty gets one
+static void startPatternEffect(TimerWheel* wheel, HapticMotorTable* table, int index) {
+    uint8_t effect = patternEffect(table->pattern[index], table->patternIntensity[index]);
+    if (!table->driver || effect == 0) return;
+    advanceThermalModel(table, index, static_cast<unsigned long>(wheel->now));
+    if (hapticDerating(table->temperature[index]) < 1.0f) return;
+    if (drv2605PlayEffects(table->driver, index, &effect, 1)) setMask(&table->effectMask, index, true);
+}
+
+static void patternStartTimer(TimerWheel* wheel, void* context) {
+    HapticMotorRef* ref = static_cast<HapticMotorRef*>(context);
+    HapticMotorTable* table = ref->table;
+    int index = ref->index;
+    startPatternEffect(wheel, table, index);
+    driveMotor(wheel, table, index, waveformDuty(table->pattern[index], table->patternIntensity[index], 0));
+    table->timer[index] = schedulePeriodicTimer(wheel, 1, patternTickTimer, ref);
+}
+
+// Plays a pattern's waveform after `delay` ms
+static void startPattern(HapticMotorTable* table, int index, HapticPattern pattern, int intensity,
+                         unsigned long delay) {
+    TimerWheel* wheel = currentWheel;
+    stopMotor(wheel, table, index);
+    if (pattern == NONE || !hapticEnabled(wheel, table)) return;
+
+    table->pattern[index] = pattern;
+    table->duration[index] = waveformLength(pattern);
+    startMotor(table, index, intensity, static_cast<unsigned long>(wheel->now + delay));
+    if (delay > 0) {
+        table->timer[index] = scheduleTimer(wheel, delay, patternStartTimer, &table->ref[index]);
+    } else {
+        patternStartTimer(wheel, &table->ref[index]);
+    }
+}
+
+// Sequence Programs
+
+static void runProgram(TimerWheel* wheel, HapticMotorTable* table, int index);
+
+static void programTimer(TimerWheel* wheel, void* context) {
+    HapticMotorRef* ref = static_cast<HapticMotorRef*>(context);
+    ref->table->timer[ref->index] = 0;
+    runProgram(wheel, ref->table, ref->index);
+}
+
+// Steps a motor's program up to its next wait, sync or end
+static void runProgram(TimerWheel* wheel, HapticMotorTable* table, int index) {
+    HapticProgram* program = &table->program[index];
+    HapticProgramStep step = stepHapticProgram(program);
+    driveMotor(wheel, table, index, program->duty * table->patternIntensity[index] / STRONG);
+    if (step.status == HAPTIC_PROGRAM_WAIT) {
+        table->timer[index] = scheduleTimer(wheel, step.delay, programTimer, &table->ref[index]);
+        if (table->timer[index] == 0) stopMotor(wheel, table, index);  // Wheel full
+    } else if (step.status == HAPTIC_PROGRAM_SYNC) {
+        program->parked = true;
+        releaseSyncedRuns(wheel, table);
+    } else {
+        stopMotor(wheel, table, index);
+    }
+}
+
+// Motors of a run, which are always active ones
+static uint32_t runMotors(const HapticMotorTable* table, uint32_t run) {
+    uint32_t members = 0;
+    for (uint32_t mask = table->activeMask; mask; mask &= mask - 1) {
+        int index = lowestMotor(mask);
+        if (table->program[index].sequence && table->program[index].run == run) members |= 1u << index;
+    }
+    return members;
+}
+
+// Restarts every run whose remaining motors are all parked. Resuming a
+// motor can park or stop it again, so nested calls only ask the
+// outermost one for another pass.
+static void releaseSyncedRuns(TimerWheel* wheel, HapticMotorTable* table) {
+    if (releasingRuns) {
+        releaseAgain = true;
+        return;
+    }
+    releasingRuns = true;
+    do {
+        releaseAgain = false;
+        for (uint32_t mask = table->activeMask; mask; mask &= mask - 1) {
+            const HapticProgram& program = table->program[lowestMotor(mask)];
+            if (!program.sequence || !program.parked) continue;
+
+            uint32_t run = program.run;
+            uint32_t members = runMotors(table, run);
+            bool moving = false;
+            for (uint32_t left = members; left; left &= left - 1) {
+                moving = moving || !table->program[lowestMotor(left)].parked;
+            }
+            if (moving) continue;
+
+            for (uint32_t left = members; left; left &= left - 1) {
+                table->program[lowestMotor(left)].parked = false;
+            }
+            for (uint32_t left = members; left; left &= left - 1) {
+                int index = lowestMotor(left);
+                if (table->program[index].sequence && table->program[index].run == run) {
+                    runProgram(wheel, table, index);
+                }
+            }
+            releaseAgain = true;
+            break;  // activeMask may have changed under the scan
+        }
+    } while (releaseAgain);
+    releasingRuns = false;
+}
+
+// Public API
+
+// Motors, wheels and drivers belong to each trainer; only the cues are shared
+void initHapticSystem() {
+    loadHapticCues(HAPTIC_CUE_DIRECTORY);
+}
+
+void initHapticMotors(HapticMotorTable* table, const int* pins, int count) {
+    table->count = std::max(0, std::min(count, HAPTIC_MAX_MOTORS));
+    table->activeMask = 0;
+    table->drivenMask = 0;
+    table->effectMask = 0;
+    std::fill(std::begin(table->pinIndex), std::end(table->pinIndex), -1);
+    for (int index = 0; index < table->count; index++) {
+        table->pin[index] = pins[index];
+        if (pins[index] >= 0 && pins[index] < HAPTIC_MAX_PIN) table->pinIndex[pins[index]] = static_cast<int8_t>(index);
+        table->currentIntensity[index] = 0;
+        table->drive[index] = 0;
+        table->startTime[index] = 0;
+        table->duration[index] = 0;
+        table->pattern[index] = NONE;
+        table->patternIntensity[index] = 0;
+        table->timer[index] = 0;
+        table->priority[index] = HAPTIC_PRIORITY_CONFIRMATION;
+        table->temperature[index] = 0.0f;
+        table->thermalTime[index] = 0;
+        table->thermalTimer[index] = 0;
+        table->program[index] = HapticProgram();
+        table->ref[index] = {table, index};
+    }
+    table->enabled = true;
+    table->overheated = false;
+    table->cooldownTimer = 0;
+}
+
+// Haptic Cues
+
+static const char* const HAPTIC_CUE_NAMES[HAPTIC_CUE_COUNT] = {
+    "good_form",
+    "elbow_correction",
+    "wrist_correction",
+};
+
+// A missing file keeps the built-in feedback; a broken one is reported
+// and kept out, so a typo never silences a cue
+int loadHapticCues(const std::string& directory) {
+    int loaded = 0;
+    for (int cue = 0; cue < HAPTIC_CUE_COUNT; cue++) {
+        std::string filename = directory + "/" + HAPTIC_CUE_NAMES[cue] + ".hseq";
+        int errorLine = 0;
+        if (!loadHapticSequence(filename, &hapticCues[cue], &errorLine)) {
+            hapticCues[cue].length = 0;
+            if (errorLine > 0) {
+                std::cerr << filename << ":" << errorLine << ": invalid cue, using the built-in one" << std::endl;
+            }
+            continue;
+        }
+        loaded++;
+    }
+    std::cout << "Haptic cues loaded: " << loaded << std::endl;
+    return loaded;
+}
+
+const HapticSequence* hapticCue(HapticCue cue) {
+    if (cue < 0 || cue >= HAPTIC_CUE_COUNT || hapticCues[cue].length == 0) return nullptr;
+    return &hapticCues[cue];
+}
+
+void attachHapticDriver(HapticMotorTable* table, Drv2605Array* driver) {
+    table->driver = driver;
+}
+
+void bindHapticMotors(HapticMotorTable* table, TimerWheel* wheel) {
+    currentMotors = table;
+    currentWheel = wheel;
+}
+
+void triggerHapticFeedback(int pin, int intensity, unsigned long duration) {
+    HapticMotorTable* table = currentMotors;
+    int index = getMotorIndex(pin);
+    if (index < 0 || !hapticEnabled(currentWheel, table)) return;
+
+    stopMotor(currentWheel, table, index);
+    table->pattern[index] = CONTINUOUS;
+    table->duration[index] = duration;
+    startMotor(table, index, intensity, static_cast<unsigned long>(currentWheel->now));
+    driveMotor(currentWheel, table, index, table->patternIntensity[index]);
+    table->timer[index] = scheduleTimer(currentWheel, duration, motorOffTimer, &table->ref[index]);
+}
+
+void triggerPatternFeedback(FeedbackZone zone, HapticPattern pattern, FeedbackIntensity intensity) {
+    HapticMotorTable* table = currentMotors;
+    if (zone != ALL_ZONES) {
+        if (validMotor(table, zone - 1)) startPattern(table, zone - 1, pattern, intensity, 0);
+        return;
+    }
+
+    for (int index = 0; index < table->count; index++) {
+        startPattern(table, index, pattern, intensity, patternZoneDelay(pattern, index));
+    }
+}
+
+void triggerSequenceFeedback(FeedbackZone zone, const HapticSequence* sequence, FeedbackIntensity intensity) {
+    uint32_t zoneMask = zone == ALL_ZONES ? UINT32_MAX : 1u << (zone - 1);
+    startZoneSequence(zoneMask, sequence, intensity, HAPTIC_PRIORITY_CONFIRMATION);
+}
+
+// Fires whatever motor timers are due: a table lookup or program step per
+// playing motor per timer, nothing for idle ones
+void updateHapticFeedback() {
+    advanceTimerWheel(currentWheel, hapticNow());
+    if (currentMotors->driver) runI2cBus(currentMotors->driver->bus, traceTimestampNs());  // Writes the bus held back
+}
+
+void stopAllHapticFeedback() {
+    HapticMotorTable* table = currentMotors;
+    for (uint32_t mask = table->activeMask | table->drivenMask; mask; mask &= mask - 1) {
+        stopMotor(currentWheel, table, lowestMotor(mask));
+    }
+}
+
+void setHapticIntensity(int pin, int intensity) {
+    int index = getMotorIndex(pin);
+    if (index < 0) return;
+
+    // In real implementation, write the PWM duty cycle
+    bool enabled = hapticEnabled(currentWheel, currentMotors);
+    driveMotor(currentWheel, currentMotors, index, enabled ? std::max(0, std::min(intensity, 255)) : 0);
+}
+
+void enableHapticSystem(bool enable) {
+    currentMotors->enabled = enable;
+    if (!enable) stopAllHapticFeedback();
+}
+
+// Pattern Functions
+
+static void executePattern(int index, HapticPattern pattern) {
+    HapticMotorTable* table = currentMotors;
+    if (!validMotor(table, index)) return;
+    int intensity = table->patternIntensity[index] > 0 ? table->patternIntensity[index] : MEDIUM;
+    startPattern(table, index, pattern, intensity, 0);
+}
+
+void executeSinglePulse(int index) {
+    executePattern(index, SINGLE_PULSE);
+}
+
+void executeDoublePulse(int index) {
+    executePattern(index, DOUBLE_PULSE);
+}
+
+void executeTriplePulse(int index) {
+    executePattern(index, TRIPLE_PULSE);
+}
+
+void executeContinuous(int index) {
+    executePattern(index, CONTINUOUS);
+}
+
+void executeIncreasing(int index) {
+    executePattern(index, INCREASING);
+}
+
+void executeDecreasing(int index) {
+    executePattern(index, DECREASING);
+}
+
+void executeAlternating() {
+    triggerPatternFeedback(ALL_ZONES, ALTERNATING, MEDIUM);
+}
+
+void executeWave() {
+    triggerPatternFeedback(ALL_ZONES, WAVE, MEDIUM);
+}
+
+// Form-Specific Feedback Functions
+
+void feedbackPoorForm() {
+    triggerPatternFeedback(ALL_ZONES, TRIPLE_PULSE, STRONG);
+}
+
+void feedbackModerateForm() {
+    triggerPatternFeedback(ALL_ZONES, DOUBLE_PULSE, MEDIUM);
+}
+
+void feedbackGoodForm() {
+    triggerPatternFeedback(ALL_ZONES, SINGLE_PULSE, LIGHT);
+}
+
+void feedbackTooSlow() {
+    triggerPatternFeedback(WRIST, INCREASING, MEDIUM);
+}
+
+void feedbackTooFast() {
+    triggerPatternFeedback(WRIST, DECREASING, MEDIUM);
+}
+
+void feedbackOffTrajectory() {
+    triggerPatternFeedback(ALL_ZONES, ALTERNATING, STRONG);
+}
+
+void feedbackCorrectForm() {
+    triggerPatternFeedback(ALL_ZONES, WAVE, LIGHT);
+}
+
+// Utility Functions
+
+int getMotorIndex(int pin) {
+    if (pin < 0 || pin >= HAPTIC_MAX_PIN) return -1;
+    return currentMotors->pinIndex[pin];
+}
+
+void setMotorPattern(int pin, HapticPattern pattern, int intensity, unsigned long duration) {
+    int index = getMotorIndex(pin);
+    if (index < 0) return;
+
+    if (pattern == CONTINUOUS) {
+        triggerHapticFeedback(pin, intensity, duration);  // Held for `duration` rather than the waveform's
+    } else {
+        startPattern(currentMotors, index, pattern, intensity, 0);
+    }
+}
+
+bool isMotorActive(int pin) {
+    int index = getMotorIndex(pin);
+    return index >= 0 && (currentMotors->activeMask >> index & 1);
+}
+
+// Motors switch off from their own timers; this only catches ones left
+// driven by setHapticIntensity() without a pattern
+void cleanupInactiveMotors() {
+    HapticMotorTable* table = currentMotors;
+    for (uint32_t mask = table->drivenMask & ~table->activeMask; mask; mask &= mask - 1) {
+        int index = lowestMotor(mask);
+        if (table->timer[index] == 0) driveMotor(currentWheel, table, index, 0);
+    }
+}
+
+// Zone Functions
+
+int hapticZoneCount() {
+    return currentMotors->count;
+}
+
+bool isZoneActive(int index) {
+    return validMotor(currentMotors, index) && (currentMotors->activeMask >> index & 1);
+}
+
+HapticPriority zonePriority(int index) {
+    return validMotor(currentMotors, index) ? currentMotors->priority[index] : HAPTIC_PRIORITY_CONFIRMATION;
+}
+
+// Zones of ALL_ZONES patterns that take turns or sweep along the arm
+unsigned long patternZoneDelay(HapticPattern pattern, int index) {
+    switch (pattern) {
+        case ALTERNATING: return (index % 2) * ALTERNATING_ZONE_DELAY_MS;
+        case WAVE: return index * WAVE_ZONE_DELAY_MS;
+        default: return 0;
+    }
+}
+
+void startZonePulse(int index, int intensity, unsigned long duration, HapticPriority priority) {
+    HapticMotorTable* table = currentMotors;
+    if (!validMotor(table, index)) return;
+    triggerHapticFeedback(table->pin[index], intensity, duration);
+    if (isZoneActive(index)) table->priority[index] = priority;
+}
+
+void startZonePattern(int index, HapticPattern pattern, int intensity, unsigned long delay,
+                      HapticPriority priority) {
+    HapticMotorTable* table = currentMotors;
+    if (!validMotor(table, index)) return;
+    startPattern(table, index, pattern, intensity, delay);
+    if (isZoneActive(index)) table->priority[index] = priority;
+}
+
+// Stops every zone first, since stopping one can resume its old run, then
+// loads them all parked so none starts before the others are ready
+void startZoneSequence(uint32_t zoneMask, const HapticSequence* sequence, int intensity,
+                       HapticPriority priority) {
+    HapticMotorTable* table = currentMotors;
+    if (!sequence || sequence->length == 0 || !hapticEnabled(currentWheel, table)) return;
+    uint32_t zones = zoneMask & ((1u << table->count) - 1);
+    for (uint32_t mask = zones; mask; mask &= mask - 1) {
+        stopMotor(currentWheel, table, lowestMotor(mask));
+    }
+
+    uint32_t run = ++lastSequenceRun;
+    for (uint32_t mask = zones; mask; mask &= mask - 1) {
+        int index = lowestMotor(mask);
+        initHapticProgram(&table->program[index], sequence, index);
+        table->program[index].run = run;
+        table->program[index].parked = true;
+        table->priority[index] = priority;
+        startMotor(table, index, intensity, static_cast<unsigned long>(currentWheel->now));
+    }
+    releaseSyncedRuns(currentWheel, table);
+}
+
+void stopZone(int index) {
+    if (!validMotor(currentMotors, index)) return;
+    stopMotor(currentWheel, currentMotors, index);
+}
+
+// Safety Functions
+
+float hapticDerating(float temperature) {
+    if (temperature <= HAPTIC_DERATE_START) return 1.0f;
+    if (temperature >= HAPTIC_DERATE_END) return HAPTIC_DERATE_FLOOR;
+    float fraction = (temperature - HAPTIC_DERATE_START) / (HAPTIC_DERATE_END - HAPTIC_DERATE_START);
+    return 1.0f - (1.0f - HAPTIC_DERATE_FLOOR) * fraction;
+}
+
+// Undriven motors only cool, so their last temperature bounds the real one
+bool isSystemOverheating() {
+    HapticMotorTable* table = currentMotors;
+    unsigned long now = static_cast<unsigned long>(currentWheel->now);
+    for (int index = 0; index < table->count; index++) {
+        if (table->drivenMask >> index & 1) advanceThermalModel(table, index, now);
+        if (table->temperature[index] >= HAPTIC_TEMPERATURE_LIMIT) return true;
+    }
+    return false;
+}
+
+// Re-derates every driven motor against its current temperature; the
+// emergency stop is only for when derating was not enough
+void checkMotorTemperature() {
+    HapticMotorTable* table = currentMotors;
+    for (uint32_t mask = table->drivenMask; mask; mask &= mask - 1) {
+        int index = lowestMotor(mask);
+        driveMotor(currentWheel, table, index, table->drive[index]);
+    }
+    if (isSystemOverheating()) emergencyStop();
+}
+
+void emergencyStop() {
+    isSystemOverheating();  // Brings the driven motors' models up to date for the trace
+    thermalShutdown(currentWheel, currentMotors);
+}
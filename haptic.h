@@ -1,18 +1,36 @@
 /*
  * Haptic Feedback Control for Basketball Training System
  * Standard C++ version for Visual Studio Code
+ *
+ * Every motor off-time and waveform tick is a timer on a TimerWheel, so
+ * updateHapticFeedback() only touches the motors whose timers fire. The
+ * functions below drive the motors and wheel a trainer has bound to the
+ * calling thread with bindHapticMotors(); an unbound thread has none.
+ * Sequence programs (haptic_sequence.h) step on the same timers. Motors
+ * live in a HapticMotorTable: pins map to zones in O(1), and whole-table
+ * work scans the active and driven bitmasks rather than every motor.
+ *
+ * Each motor carries a first-order thermal model of its coil, advanced
+ * in O(1) whenever its duty changes and every HAPTIC_THERMAL_TICK while
+ * it is driven. As the coil warms, the duty is derated, so sustained
+ * STRONG feedback settles below HAPTIC_TEMPERATURE_LIMIT instead of
+ * reaching emergencyStop().
  */
 
 #ifndef HAPTIC_H
 #define HAPTIC_H
 
-#include <vector>
 #include <chrono>
+#include <cstdint>
+#include "timer_wheel.h"
+#include "haptic_sequence.h"
+#include "drv2605.h"
 
 // Pin Definitions (for ESP32 reference)
 const int HAPTIC_1_PIN = 25;  // Upper arm
 const int HAPTIC_2_PIN = 26;  // Lower arm  
 const int HAPTIC_3_PIN = 27;  // Wrist
+const int HAPTIC_DRIVER_CHANNEL = 0;  // Mux channel of the first motor's DRV2605L
 
 // Haptic Feedback Patterns
 enum HapticPattern {
@@ -42,42 +60,111 @@ enum FeedbackZone {
     ALL_ZONES = 0
 };
 
-// Haptic Motor Control Structure
-struct HapticMotor {
-    int pin;
-    int currentIntensity;
-    bool isActive;
-    unsigned long startTime;
-    unsigned long duration;
-    HapticPattern pattern;
+// Command priorities (haptic_queue.h); higher preempts lower on a zone
+enum HapticPriority {
+    HAPTIC_PRIORITY_CONFIRMATION,  // Shot recorded, calibration shot taken, good form
+    HAPTIC_PRIORITY_CORRECTION,    // Form corrections
+    HAPTIC_PRIORITY_SAFETY,        // Stops
+    HAPTIC_PRIORITY_COUNT
+};
+
+// Feedback cues a coach can replace without a rebuild: initHapticSystem()
+// assembles HAPTIC_CUE_DIRECTORY/<name>.hseq for each one that has a file
+enum HapticCue {
+    HAPTIC_CUE_GOOD_FORM,         // good_form.hseq
+    HAPTIC_CUE_ELBOW_CORRECTION,  // elbow_correction.hseq
+    HAPTIC_CUE_WRIST_CORRECTION,  // wrist_correction.hseq
+    HAPTIC_CUE_COUNT
+};
+
+const char* const HAPTIC_CUE_DIRECTORY = "cues";
+
+// Safety Limits (temperatures are °C above ambient)
+const float HAPTIC_THERMAL_TIME_CONSTANT = 20000.0f;  // ms
+const float HAPTIC_FULL_DRIVE_RISE = 60.0f;           // Steady state at full duty
+const float HAPTIC_DERATE_START = 30.0f;              // Full duty below this
+const float HAPTIC_DERATE_END = 42.0f;                // HAPTIC_DERATE_FLOOR of the duty from here
+const float HAPTIC_DERATE_FLOOR = 0.3f;
+const float HAPTIC_TEMPERATURE_LIMIT = 45.0f;         // Emergency stop
+const unsigned long HAPTIC_THERMAL_TICK = 50;         // ms between model updates of a held duty
+
+// Motor Table Limits
+const int HAPTIC_MAX_MOTORS = 8;  // Bits used in the table's masks
+const int HAPTIC_MAX_PIN = 40;    // ESP32 GPIOs 0-39
+
+// Motors on the sleeve, by zone
+const int HAPTIC_MOTOR_PINS[] = {HAPTIC_1_PIN, HAPTIC_2_PIN, HAPTIC_3_PIN};
+const int HAPTIC_MOTOR_COUNT = sizeof(HAPTIC_MOTOR_PINS) / sizeof(HAPTIC_MOTOR_PINS[0]);
+
+struct HapticMotorTable;
+
+// Timer context naming one motor of a table
+struct HapticMotorRef {
+    HapticMotorTable* table;
+    int index;
+};
+
+// Motor state as parallel arrays indexed by zone (FeedbackZone - 1), plus
+// bitmasks of the motors playing something and the motors driven at a
+// non-zero duty, so whole-table work visits only those. Timers point into
+// the table, so it is never copied once initialized.
+struct HapticMotorTable {
+    int count;
+    uint32_t activeMask;               // Playing a pulse, pattern or sequence
+    uint32_t drivenMask;               // Non-zero drive duty
+    uint32_t effectMask;               // Pulse played as a driver library effect
+    int8_t pinIndex[HAPTIC_MAX_PIN];   // Zone index per pin, -1 for none
+
+    int pin[HAPTIC_MAX_MOTORS];
+    int currentIntensity[HAPTIC_MAX_MOTORS];    // Applied duty: drive after derating
+    int drive[HAPTIC_MAX_MOTORS];               // Duty asked for
+    unsigned long startTime[HAPTIC_MAX_MOTORS];
+    unsigned long duration[HAPTIC_MAX_MOTORS];
+    HapticPattern pattern[HAPTIC_MAX_MOTORS];
+    int patternIntensity[HAPTIC_MAX_MOTORS];    // Intensity the pattern's waveform is played at
+    TimerId timer[HAPTIC_MAX_MOTORS];           // Off-time, waveform tick or program step
+    HapticPriority priority[HAPTIC_MAX_MOTORS]; // Of what is playing; direct calls play at the lowest
+    float temperature[HAPTIC_MAX_MOTORS];       // Coil rise above ambient, from the thermal model
+    unsigned long thermalTime[HAPTIC_MAX_MOTORS];  // Wheel ms the model has been advanced to
+    TimerId thermalTimer[HAPTIC_MAX_MOTORS];    // HAPTIC_THERMAL_TICK while driven
+    HapticProgram program[HAPTIC_MAX_MOTORS];   // Sequence being played, if any
+    HapticMotorRef ref[HAPTIC_MAX_MOTORS];
+    Drv2605Array* driver;                       // Duty changes go out over it when attached
+    bool enabled;                               // enableHapticSystem() for the tables bound to a thread
+    bool overheated;                            // Emergency stop, until the coils cool
+    TimerId cooldownTimer;                      // Lifts `overheated`
     
-    HapticMotor() : pin(0), currentIntensity(0), isActive(false), 
-                   startTime(0), duration(0), pattern(NONE) {}
+    HapticMotorTable() : count(0), activeMask(0), drivenMask(0), effectMask(0), pinIndex(), pin(), currentIntensity(),
+                         drive(), startTime(), duration(), pattern(), patternIntensity(), timer(),
+                         priority(), temperature(), thermalTime(), thermalTimer(), program(), ref(), driver(nullptr),
+                         enabled(true), overheated(false), cooldownTimer(0) {}
     
-    HapticMotor(int p) : pin(p), currentIntensity(0), isActive(false), 
-                        startTime(0), duration(0), pattern(NONE) {}
+    HapticMotorTable(const HapticMotorTable&) = delete;
+    HapticMotorTable& operator=(const HapticMotorTable&) = delete;
 };
 
-// Global Variables
-extern std::vector<HapticMotor> motors;
-extern bool hapticSystemEnabled;
-
 // Function Declarations
 void initHapticSystem();
+void initHapticMotors(HapticMotorTable* table, const int* pins, int count);
 void triggerHapticFeedback(int pin, int intensity, unsigned long duration);
 void triggerPatternFeedback(FeedbackZone zone, HapticPattern pattern, FeedbackIntensity intensity);
+void triggerSequenceFeedback(FeedbackZone zone, const HapticSequence* sequence, FeedbackIntensity intensity);
 void updateHapticFeedback();
 void stopAllHapticFeedback();
 void setHapticIntensity(int pin, int intensity);
-void enableHapticSystem(bool enable);
+void enableHapticSystem(bool enable);  // Bound table only
+void bindHapticMotors(HapticMotorTable* table, TimerWheel* wheel);  // Calling thread
+void attachHapticDriver(HapticMotorTable* table, Drv2605Array* driver);  // One device per zone
+int loadHapticCues(const std::string& directory);  // Before any trainer runs; returns the cues loaded
+const HapticSequence* hapticCue(HapticCue cue);    // nullptr: play the built-in feedback
 
 // Pattern Functions
-void executeSinglePulse(HapticMotor* motor);
-void executeDoublePulse(HapticMotor* motor);
-void executeTriplePulse(HapticMotor* motor);
-void executeContinuous(HapticMotor* motor);
-void executeIncreasing(HapticMotor* motor);
-void executeDecreasing(HapticMotor* motor);
+void executeSinglePulse(int index);
+void executeDoublePulse(int index);
+void executeTriplePulse(int index);
+void executeContinuous(int index);
+void executeIncreasing(int index);
+void executeDecreasing(int index);
 void executeAlternating();
 void executeWave();
 
@@ -96,9 +183,24 @@ void setMotorPattern(int pin, HapticPattern pattern, int intensity, unsigned lon
 bool isMotorActive(int pin);
 void cleanupInactiveMotors();
 
+// Zone Functions (zone index = FeedbackZone - 1, used by haptic_queue.h)
+int hapticZoneCount();
+bool isZoneActive(int index);
+HapticPriority zonePriority(int index);
+unsigned long patternZoneDelay(HapticPattern pattern, int index);  // Offset within an ALL_ZONES pattern
+void startZonePulse(int index, int intensity, unsigned long duration, HapticPriority priority);
+void startZonePattern(int index, HapticPattern pattern, int intensity, unsigned long delay,
+                      HapticPriority priority);
+void startZoneSequence(uint32_t zoneMask, const HapticSequence* sequence, int intensity,
+                       HapticPriority priority);  // One run: the zones sync with each other
+void stopZone(int index);
+
 // Safety Functions
+// An emergency stop locks out only the bound table, and lifts once every
+// coil has cooled below HAPTIC_DERATE_START
 void checkMotorTemperature();
 void emergencyStop();
 bool isSystemOverheating();
+float hapticDerating(float temperature);  // Fraction of the asked duty a motor this warm gets
 
 #endif // HAPTIC_H
@@ -0,0 +1,193 @@
+/*
+ * Haptic Command Queue for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "haptic_queue.h"
+#include "metrics.h"
+#include "trace_log.h"
+#include <algorithm>
+
+const uint64_t HAPTIC_QUEUE_MASK = HAPTIC_QUEUE_CAPACITY - 1;
+
+static_assert((HAPTIC_QUEUE_CAPACITY & (HAPTIC_QUEUE_CAPACITY - 1)) == 0, "capacity must be a power of two");
+
+// Ring
+
+static void initRing(HapticRing* ring) {
+    for (int i = 0; i < HAPTIC_QUEUE_CAPACITY; i++) {
+        ring->cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    ring->tail.store(0, std::memory_order_relaxed);
+    ring->head.store(0, std::memory_order_release);
+}
+
+static bool pushRing(HapticRing* ring, const HapticCommand& command) {
+    uint64_t position = ring->tail.load(std::memory_order_relaxed);
+    HapticQueueCell* cell;
+    while (true) {
+        cell = &ring->cells[position & HAPTIC_QUEUE_MASK];
+        uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        int64_t lag = static_cast<int64_t>(sequence - position);
+        if (lag == 0) {
+            if (ring->tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        } else if (lag < 0) {
+            return false;  // Full: the consumer has not freed this cell yet
+        } else {
+            position = ring->tail.load(std::memory_order_relaxed);
+        }
+    }
+    cell->command = command;
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+static bool popRing(HapticRing* ring, HapticCommand* command) {
+    uint64_t position = ring->head.load(std::memory_order_relaxed);
+    HapticQueueCell* cell = &ring->cells[position & HAPTIC_QUEUE_MASK];
+    if (cell->sequence.load(std::memory_order_acquire) != position + 1) return false;
+
+    *command = cell->command;
+    cell->sequence.store(position + HAPTIC_QUEUE_CAPACITY, std::memory_order_release);
+    ring->head.store(position + 1, std::memory_order_relaxed);
+    return true;
+}
+
+// Public API
+
+void initHapticQueue(HapticQueue* queue) {
+    for (HapticRing& ring : queue->rings) {
+        initRing(&ring);
+    }
+}
+
+bool queueHapticCommand(HapticQueue* queue, const HapticCommand& command) {
+    HapticCommand queued = command;
+    queued.queuedNs = traceTimestampNs();
+    if (pushRing(&queue->rings[command.priority], queued)) return true;
+
+    incrementMetric(METRIC_HAPTIC_REJECTED);
+    return false;
+}
+
+bool queueHapticPulse(HapticQueue* queue, HapticPriority priority, int pin, int intensity, unsigned long duration) {
+    int index = getMotorIndex(pin);
+    if (index < 0) return false;
+
+    HapticCommand command;
+    command.kind = HAPTIC_COMMAND_PULSE;
+    command.priority = priority;
+    command.zone = static_cast<FeedbackZone>(index + 1);
+    command.intensity = intensity;
+    command.duration = duration;
+    return queueHapticCommand(queue, command);
+}
+
+bool queueHapticPattern(HapticQueue* queue, HapticPriority priority, FeedbackZone zone, HapticPattern pattern,
+                        FeedbackIntensity intensity) {
+    HapticCommand command;
+    command.kind = HAPTIC_COMMAND_PATTERN;
+    command.priority = priority;
+    command.zone = zone;
+    command.pattern = pattern;
+    command.intensity = intensity;
+    return queueHapticCommand(queue, command);
+}
+
+bool queueHapticSequence(HapticQueue* queue, HapticPriority priority, FeedbackZone zone,
+                         const HapticSequence* sequence, FeedbackIntensity intensity) {
+    HapticCommand command;
+    command.kind = HAPTIC_COMMAND_SEQUENCE;
+    command.priority = priority;
+    command.zone = zone;
+    command.sequence = sequence;
+    command.intensity = intensity;
+    return queueHapticCommand(queue, command);
+}
+
+bool queueHapticStop(HapticQueue* queue, FeedbackZone zone) {
+    HapticCommand command;
+    command.kind = HAPTIC_COMMAND_STOP;
+    command.priority = HAPTIC_PRIORITY_SAFETY;
+    command.zone = zone;
+    return queueHapticCommand(queue, command);
+}
+
+// Dispatch
+
+// Whether a zone takes a command: not if what it plays outranks it
+static bool zoneAccepts(int index, const HapticCommand& command) {
+    if (index >= hapticZoneCount()) return false;
+    if (isZoneActive(index) && zonePriority(index) > command.priority) {
+        incrementMetric(METRIC_HAPTIC_REJECTED);
+        return false;
+    }
+    return true;
+}
+
+static void applyZoneCommand(int index, const HapticCommand& command) {
+    switch (command.kind) {
+        case HAPTIC_COMMAND_PULSE:
+            startZonePulse(index, command.intensity, command.duration, command.priority);
+            break;
+        case HAPTIC_COMMAND_PATTERN: {
+            unsigned long delay = command.zone == ALL_ZONES ? patternZoneDelay(command.pattern, index) : 0;
+            startZonePattern(index, command.pattern, command.intensity, delay, command.priority);
+            break;
+        }
+        case HAPTIC_COMMAND_SEQUENCE:
+            break;  // Started for all its zones at once, so they can sync
+        case HAPTIC_COMMAND_STOP:
+            stopZone(index);
+            break;
+    }
+    recordStageLatency(STAGE_HAPTIC_QUEUE, traceTimestampNs() - command.queuedNs);
+}
+
+int dispatchHapticQueue(HapticQueue* queue) {
+    const HapticCommand* chosen[HAPTIC_MAX_ZONES] = {};
+    HapticCommand drained[HAPTIC_PRIORITY_COUNT * HAPTIC_QUEUE_CAPACITY];
+    int zones = std::min(hapticZoneCount(), HAPTIC_MAX_ZONES);
+    int count = 0;
+
+    // Highest priority first, so a zone keeps the first priority that
+    // claims it and the latest command within that priority. At most one
+    // ring's worth per priority, even if producers keep pushing.
+    for (int priority = HAPTIC_PRIORITY_COUNT - 1; priority >= 0; priority--) {
+        int claimedBefore = count;
+        for (int popped = 0; popped < HAPTIC_QUEUE_CAPACITY && popRing(&queue->rings[priority], &drained[count]);
+             popped++) {
+            const HapticCommand* command = &drained[count++];
+            int first = command->zone == ALL_ZONES ? 0 : command->zone - 1;
+            int last = command->zone == ALL_ZONES ? zones - 1 : command->zone - 1;
+            for (int index = first; index <= last && index < zones; index++) {
+                if (chosen[index] && chosen[index] < &drained[claimedBefore]) {
+                    incrementMetric(METRIC_HAPTIC_COALESCED);  // Outranked this step
+                } else {
+                    if (chosen[index]) incrementMetric(METRIC_HAPTIC_COALESCED);  // Superseded
+                    chosen[index] = command;
+                }
+            }
+        }
+    }
+
+    int applied = 0;
+    uint32_t sequenceZones[HAPTIC_MAX_ZONES] = {};  // By the first zone a sequence command won
+    for (int index = 0; index < zones; index++) {
+        if (!chosen[index] || !zoneAccepts(index, *chosen[index])) continue;
+        applyZoneCommand(index, *chosen[index]);
+        applied++;
+        if (chosen[index]->kind != HAPTIC_COMMAND_SEQUENCE) continue;
+
+        int first = 0;
+        while (chosen[first] != chosen[index]) first++;
+        sequenceZones[first] |= 1u << index;
+    }
+    for (int index = 0; index < zones; index++) {
+        if (sequenceZones[index] == 0) continue;
+        const HapticCommand* command = chosen[index];
+        startZoneSequence(sequenceZones[index], command->sequence, command->intensity, command->priority);
+    }
+    if (applied > 0) incrementMetric(METRIC_HAPTIC_COMMANDS, applied);
+    return applied;
+}
@@ -0,0 +1,76 @@
+/*
+ * Haptic Command Queue for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Feedback is queued rather than sent straight to the motors, so handlers
+ * cannot clobber each other on a zone. Each priority has a bounded
+ * lock-free ring that any thread may push to; the trainer's own thread
+ * dispatches once per step. Dispatch keeps one command per zone (the
+ * highest priority, latest within a priority), so redundant commands in
+ * a step coalesce. A command preempts whatever its zone is playing unless
+ * that outranks it, so a correction cuts a long CONTINUOUS confirmation
+ * short and a safety stop beats everything. A full ring rejects the
+ * command instead of blocking, which keeps feedback latency bounded.
+ */
+
+#ifndef HAPTIC_QUEUE_H
+#define HAPTIC_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include "haptic.h"
+
+// Queue Configuration
+const int HAPTIC_QUEUE_CAPACITY = 16;  // Per priority, power of two
+const int HAPTIC_MAX_ZONES = HAPTIC_MAX_MOTORS;
+
+enum HapticCommandKind : uint8_t {
+    HAPTIC_COMMAND_PULSE,    // One motor at a fixed intensity for a duration
+    HAPTIC_COMMAND_PATTERN,  // A waveform on one zone or ALL_ZONES
+    HAPTIC_COMMAND_SEQUENCE, // A sequence program on one zone or ALL_ZONES
+    HAPTIC_COMMAND_STOP      // One zone or ALL_ZONES
+};
+
+struct HapticCommand {
+    HapticCommandKind kind;
+    HapticPriority priority;
+    FeedbackZone zone;
+    HapticPattern pattern;
+    const HapticSequence* sequence;  // Must outlive the command
+    int intensity;
+    unsigned long duration;  // ms, pulses only
+    uint64_t queuedNs;       // traceTimestampNs() when queued
+
+    HapticCommand() : kind(HAPTIC_COMMAND_STOP), priority(HAPTIC_PRIORITY_CONFIRMATION), zone(ALL_ZONES),
+                      pattern(NONE), sequence(nullptr), intensity(0), duration(0), queuedNs(0) {}
+};
+
+// Bounded multi-producer ring after D. Vyukov: each cell's sequence says
+// whether it is free for the producer or filled for the consumer
+struct HapticQueueCell {
+    std::atomic<uint64_t> sequence;
+    HapticCommand command;
+};
+
+struct HapticRing {
+    HapticQueueCell cells[HAPTIC_QUEUE_CAPACITY];
+    alignas(64) std::atomic<uint64_t> tail;  // Producers
+    alignas(64) std::atomic<uint64_t> head;  // Consumer
+};
+
+struct HapticQueue {
+    HapticRing rings[HAPTIC_PRIORITY_COUNT];
+};
+
+// Function Declarations
+void initHapticQueue(HapticQueue* queue);
+bool queueHapticCommand(HapticQueue* queue, const HapticCommand& command);  // Any thread; false if full
+bool queueHapticPulse(HapticQueue* queue, HapticPriority priority, int pin, int intensity, unsigned long duration);
+bool queueHapticPattern(HapticQueue* queue, HapticPriority priority, FeedbackZone zone, HapticPattern pattern,
+                        FeedbackIntensity intensity);
+bool queueHapticSequence(HapticQueue* queue, HapticPriority priority, FeedbackZone zone,
+                         const HapticSequence* sequence, FeedbackIntensity intensity);
+bool queueHapticStop(HapticQueue* queue, FeedbackZone zone = ALL_ZONES);  // Safety priority
+int dispatchHapticQueue(HapticQueue* queue);  // Owning thread, motors bound; returns commands applied
+
+#endif // HAPTIC_QUEUE_H
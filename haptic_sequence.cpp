@@ -0,0 +1,230 @@
+/*
+ * Haptic Sequence Bytecode for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "haptic_sequence.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+const int HAPTIC_SEQUENCE_ZONES = 8;  // Bits in a HAPTIC_OP_ZONE mask
+const int HAPTIC_WORD_SIZE = 16;
+
+static_assert(sizeof(HapticInstruction) == 4, "instructions are four bytes");
+
+// Assembler
+
+struct SequenceAssembler {
+    HapticSequence* sequence;
+    int loopStart[HAPTIC_SEQUENCE_MAX_LOOP_DEPTH];
+    bool loopTimed[HAPTIC_SEQUENCE_MAX_LOOP_DEPTH];  // Body takes time, so it cannot spin
+    int depth;
+};
+
+static bool statementEnds(char c) {
+    return c == '\0' || c == '\n' || c == ';' || c == '#';
+}
+
+static const char* skipBlanks(const char* cursor) {
+    while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r') cursor++;
+    return cursor;
+}
+
+// Next word of the statement; false once the statement is used up
+static bool readWord(const char** cursor, char* word) {
+    const char* p = skipBlanks(*cursor);
+    if (statementEnds(*p)) return false;
+
+    int length = 0;
+    while (!statementEnds(*p) && *p != ' ' && *p != '\t' && *p != '\r') {
+        if (length < HAPTIC_WORD_SIZE - 1) word[length++] = *p;
+        p++;
+    }
+    word[length] = '\0';
+    *cursor = p;
+    return true;
+}
+
+static bool readNumber(const char** cursor, long low, long high, long* value) {
+    char word[HAPTIC_WORD_SIZE];
+    if (!readWord(cursor, word)) return false;
+
+    char* end;
+    *value = std::strtol(word, &end, 10);
+    return end != word && *end == '\0' && *value >= low && *value <= high;
+}
+
+static bool emit(SequenceAssembler* assembler, HapticOpcode op, long arg, long ms) {
+    HapticSequence* sequence = assembler->sequence;
+    if (sequence->length >= HAPTIC_SEQUENCE_MAX_LENGTH - 1) return false;  // Room for the END
+
+    HapticInstruction& instruction = sequence->code[sequence->length++];
+    instruction.op = op;
+    instruction.arg = static_cast<uint8_t>(arg);
+    instruction.ms = static_cast<uint16_t>(ms);
+    if ((op == HAPTIC_OP_WAIT || op == HAPTIC_OP_RAMP) && ms > 0 && assembler->depth > 0) {
+        assembler->loopTimed[assembler->depth - 1] = true;
+    }
+    return true;
+}
+
+static bool assembleZone(SequenceAssembler* assembler, const char** cursor) {
+    char word[HAPTIC_WORD_SIZE];
+    long mask = 0;
+    while (readWord(cursor, word)) {
+        char* end;
+        long zone = std::strtol(word, &end, 10);
+        if (std::strcmp(word, "all") == 0) {
+            mask = 0xFF;
+        } else if (end != word && *end == '\0' && zone >= 1 && zone <= HAPTIC_SEQUENCE_ZONES) {
+            mask |= 1L << (zone - 1);
+        } else {
+            return false;
+        }
+    }
+    return mask != 0 && emit(assembler, HAPTIC_OP_ZONE, mask, 0);
+}
+
+static bool assembleStatement(SequenceAssembler* assembler, const char** cursor) {
+    char word[HAPTIC_WORD_SIZE];
+    if (!readWord(cursor, word)) return true;  // Blank line or comment
+
+    long arg = 0;
+    long ms = 0;
+    bool ok;
+    if (std::strcmp(word, "zone") == 0) {
+        return assembleZone(assembler, cursor);
+    } else if (std::strcmp(word, "set") == 0) {
+        ok = readNumber(cursor, 0, 255, &arg) && emit(assembler, HAPTIC_OP_SET, arg, 0);
+    } else if (std::strcmp(word, "ramp") == 0) {
+        ok = readNumber(cursor, 0, 255, &arg) && readNumber(cursor, 0, UINT16_MAX, &ms) &&
+             emit(assembler, HAPTIC_OP_RAMP, arg, ms);
+    } else if (std::strcmp(word, "wait") == 0) {
+        ok = readNumber(cursor, 0, UINT16_MAX, &ms) && emit(assembler, HAPTIC_OP_WAIT, 0, ms);
+    } else if (std::strcmp(word, "loop") == 0) {
+        if (assembler->depth >= HAPTIC_SEQUENCE_MAX_LOOP_DEPTH) return false;
+        ok = readNumber(cursor, 1, 255, &arg) && emit(assembler, HAPTIC_OP_LOOP, arg, 0);
+        assembler->loopStart[assembler->depth] = assembler->sequence->length;
+        assembler->loopTimed[assembler->depth++] = false;
+    } else if (std::strcmp(word, "next") == 0) {
+        if (assembler->depth == 0 || !assembler->loopTimed[assembler->depth - 1]) return false;
+        int start = assembler->loopStart[--assembler->depth];
+        ok = emit(assembler, HAPTIC_OP_NEXT, 0, start);
+        if (assembler->depth > 0) assembler->loopTimed[assembler->depth - 1] = true;
+    } else if (std::strcmp(word, "sync") == 0) {
+        ok = emit(assembler, HAPTIC_OP_SYNC, 0, 0);
+    } else {
+        return false;
+    }
+    return ok && !readWord(cursor, word);  // Nothing left over
+}
+
+bool assembleHapticSequence(const char* source, HapticSequence* sequence, int* errorLine) {
+    SequenceAssembler assembler;
+    assembler.sequence = sequence;
+    assembler.depth = 0;
+    sequence->length = 0;
+
+    int line = 1;
+    const char* cursor = source;
+    bool ok = true;
+    while (ok) {
+        ok = assembleStatement(&assembler, &cursor);
+        cursor = skipBlanks(cursor);
+        if (*cursor == '#') {
+            const char* newline = std::strchr(cursor, '\n');
+            cursor = newline ? newline : cursor + std::strlen(cursor);
+        }
+        if (!ok || *cursor == '\0') break;
+        if (*cursor == '\n') line++;
+        cursor++;
+    }
+    ok = ok && assembler.depth == 0 && emit(&assembler, HAPTIC_OP_END, 0, 0);
+
+    if (errorLine) *errorLine = ok ? 0 : line;
+    if (!ok) sequence->length = 0;
+    return ok;
+}
+
+bool loadHapticSequence(const std::string& filename, HapticSequence* sequence, int* errorLine) {
+    if (errorLine) *errorLine = 0;
+    std::ifstream file(filename);
+    if (!file) return false;
+
+    std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return assembleHapticSequence(source.c_str(), sequence, errorLine);
+}
+
+// Interpreter
+
+void initHapticProgram(HapticProgram* program, const HapticSequence* sequence, int zoneIndex) {
+    *program = HapticProgram();
+    program->sequence = sequence;
+    program->zoneBit = zoneIndex >= 0 && zoneIndex < HAPTIC_SEQUENCE_ZONES ? 1 << zoneIndex : 0;
+    program->selected = true;
+}
+
+// A ramp is stepped once per ms; everything else runs until the next
+// wait, sync or end. Motors a zone line leaves out skip its waits, so the
+// op budget keeps a loop they fly through from stalling the thread.
+HapticProgramStep stepHapticProgram(HapticProgram* program) {
+    const HapticSequence* sequence = program->sequence;
+    if (!sequence) return {HAPTIC_PROGRAM_DONE, 0};
+
+    if (program->ramping) {
+        program->rampElapsed++;
+        int span = program->rampTo - program->rampFrom;
+        program->duty = static_cast<uint8_t>(program->rampFrom + span * program->rampElapsed / program->rampLength);
+        if (program->rampElapsed < program->rampLength) return {HAPTIC_PROGRAM_WAIT, 1};
+        program->ramping = false;
+    }
+
+    for (int ops = 0; ops < HAPTIC_PROGRAM_MAX_OPS; ops++) {
+        if (program->pc >= sequence->length) return {HAPTIC_PROGRAM_DONE, 0};
+        const HapticInstruction& instruction = sequence->code[program->pc++];
+
+        switch (instruction.op) {
+            case HAPTIC_OP_END:
+                program->pc--;
+                return {HAPTIC_PROGRAM_DONE, 0};
+            case HAPTIC_OP_ZONE:
+                program->selected = (instruction.arg & program->zoneBit) != 0;
+                break;
+            case HAPTIC_OP_SET:
+                if (program->selected) program->duty = instruction.arg;
+                break;
+            case HAPTIC_OP_RAMP:
+                if (!program->selected) break;
+                if (instruction.ms == 0) {
+                    program->duty = instruction.arg;
+                    break;
+                }
+                program->ramping = true;
+                program->rampFrom = program->duty;
+                program->rampTo = instruction.arg;
+                program->rampElapsed = 0;
+                program->rampLength = instruction.ms;
+                return {HAPTIC_PROGRAM_WAIT, 1};
+            case HAPTIC_OP_WAIT:
+                if (program->selected && instruction.ms > 0) return {HAPTIC_PROGRAM_WAIT, instruction.ms};
+                break;
+            case HAPTIC_OP_LOOP:
+                if (program->loopDepth >= HAPTIC_SEQUENCE_MAX_LOOP_DEPTH) return {HAPTIC_PROGRAM_DONE, 0};
+                program->loopLeft[program->loopDepth++] = instruction.arg;
+                break;
+            case HAPTIC_OP_NEXT:
+                if (program->loopDepth == 0) return {HAPTIC_PROGRAM_DONE, 0};
+                if (--program->loopLeft[program->loopDepth - 1] > 0) {
+                    program->pc = instruction.ms;
+                } else {
+                    program->loopDepth--;
+                }
+                break;
+            case HAPTIC_OP_SYNC:
+                return {HAPTIC_PROGRAM_SYNC, 0};
+        }
+    }
+    return {HAPTIC_PROGRAM_WAIT, 1};
+}
@@ -0,0 +1,102 @@
+/*
+ * Haptic Sequence Bytecode for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * A cue as a short program instead of a HapticPattern, so new cues can be
+ * loaded from a config file without a rebuild. Every motor a sequence is
+ * played on runs its own copy of the program; `zone` picks which motors
+ * the following set/ramp/wait lines apply to (the others skip them), and
+ * `sync` holds each motor until every motor in the sequence reaches it.
+ * The source is assembled once into fixed 4-byte instructions, and the
+ * interpreter keeps its state in the motor, so playing a cue allocates
+ * nothing and costs nothing between timer ticks.
+ *
+ * Source, one instruction per line or separated by ';', '#' comments:
+ *
+ *     # Off trajectory: sweep up the arm twice, then a wrist buzz
+ *     loop 2
+ *         zone 1; ramp 255 80; ramp 0 40; sync
+ *         zone 2; ramp 255 80; ramp 0 40; sync
+ *         zone 3; ramp 255 80; ramp 0 40; sync
+ *     next
+ *     zone 3; set 255; wait 150
+ *
+ * Duties run 0-255 and are scaled by the intensity the sequence is played
+ * at; times are ms. Zones are FeedbackZone numbers or `all`.
+ */
+
+#ifndef HAPTIC_SEQUENCE_H
+#define HAPTIC_SEQUENCE_H
+
+#include <cstdint>
+#include <string>
+
+// Sequence Limits
+const int HAPTIC_SEQUENCE_MAX_LENGTH = 64;     // Instructions, including the final END
+const int HAPTIC_SEQUENCE_MAX_LOOP_DEPTH = 4;
+const int HAPTIC_PROGRAM_MAX_OPS = 1024;       // Per step before yielding for 1 ms
+
+enum HapticOpcode : uint8_t {
+    HAPTIC_OP_END,
+    HAPTIC_OP_ZONE,  // arg: zone bitmask
+    HAPTIC_OP_SET,   // arg: duty
+    HAPTIC_OP_RAMP,  // arg: target duty, ms: duration
+    HAPTIC_OP_WAIT,  // ms: duration
+    HAPTIC_OP_LOOP,  // arg: iterations
+    HAPTIC_OP_NEXT,  // ms: first instruction of the loop body
+    HAPTIC_OP_SYNC
+};
+
+struct HapticInstruction {
+    HapticOpcode op;
+    uint8_t arg;
+    uint16_t ms;
+};
+
+struct HapticSequence {
+    HapticInstruction code[HAPTIC_SEQUENCE_MAX_LENGTH];
+    int length;
+
+    HapticSequence() : code(), length(0) {}
+};
+
+// Interpreter state, one per motor
+struct HapticProgram {
+    const HapticSequence* sequence;  // nullptr when the motor runs no program
+    uint32_t run;                    // Motors started together share a run and sync with each other
+    uint16_t pc;
+    uint8_t zoneBit;                 // This motor's bit in HAPTIC_OP_ZONE masks
+    bool selected;                   // By the last HAPTIC_OP_ZONE
+    bool parked;                     // At a sync, or loaded and not yet started
+    uint8_t duty;
+    bool ramping;
+    uint8_t rampFrom;
+    uint8_t rampTo;
+    uint16_t rampElapsed;
+    uint16_t rampLength;
+    uint8_t loopDepth;
+    uint8_t loopLeft[HAPTIC_SEQUENCE_MAX_LOOP_DEPTH];
+
+    HapticProgram() : sequence(nullptr), run(0), pc(0), zoneBit(0), selected(false), parked(false),
+                      duty(0), ramping(false), rampFrom(0), rampTo(0), rampElapsed(0), rampLength(0),
+                      loopDepth(0), loopLeft() {}
+};
+
+enum HapticProgramStatus {
+    HAPTIC_PROGRAM_WAIT,  // Step again after `delay` ms
+    HAPTIC_PROGRAM_SYNC,  // Step again once every motor in the run is at a sync
+    HAPTIC_PROGRAM_DONE
+};
+
+struct HapticProgramStep {
+    HapticProgramStatus status;
+    uint16_t delay;
+};
+
+// Function Declarations
+bool assembleHapticSequence(const char* source, HapticSequence* sequence, int* errorLine = nullptr);
+bool loadHapticSequence(const std::string& filename, HapticSequence* sequence, int* errorLine = nullptr);
+void initHapticProgram(HapticProgram* program, const HapticSequence* sequence, int zoneIndex);
+HapticProgramStep stepHapticProgram(HapticProgram* program);  // Runs until the program must wait
+
+#endif // HAPTIC_SEQUENCE_H
@@ -0,0 +1,129 @@
+/*
+ * Haptic Waveform Tables for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Every HapticPattern's envelope rendered at compile time into PWM duty
+ * tables, one entry per millisecond, for each FeedbackIntensity. Playing
+ * a pattern is then one table lookup per motor per 1 ms tick; nothing
+ * about the envelope is computed at runtime. Other intensities scale the
+ * STRONG table.
+ */
+
+#ifndef HAPTIC_WAVEFORMS_H
+#define HAPTIC_WAVEFORMS_H
+
+#include <array>
+#include <cstdint>
+#include "haptic.h"
+
+// Pattern Timing (ms)
+constexpr int PULSE_SHORT_MS = 80;
+constexpr int PULSE_MEDIUM_MS = 100;
+constexpr int PULSE_LONG_MS = 150;
+constexpr int CONTINUOUS_MS = 1000;
+constexpr int RAMP_MS = 400;
+constexpr int RAMP_FLOOR_PERCENT = 20;  // Ramps start or end here, not at zero
+constexpr int WAVE_MS = 200;
+constexpr int WAVE_ZONE_DELAY_MS = 100;  // Each zone starts this long after the previous one
+constexpr int ALTERNATING_ZONE_DELAY_MS = PULSE_LONG_MS;  // Odd zones fill the even zones' gaps
+
+constexpr int WAVEFORM_INTENSITY_LEVELS = 3;  // LIGHT, MEDIUM, STRONG
+
+// `pulses` pulses of `on` ms separated by `off` ms gaps
+constexpr int pulseTrainLength(int on, int off, int pulses) {
+    return pulses * on + (pulses - 1) * off;
+}
+
+constexpr int waveformLength(HapticPattern pattern) {
+    switch (pattern) {
+        case SINGLE_PULSE: return PULSE_LONG_MS;
+        case DOUBLE_PULSE: return pulseTrainLength(PULSE_MEDIUM_MS, PULSE_MEDIUM_MS, 2);
+        case TRIPLE_PULSE: return pulseTrainLength(PULSE_SHORT_MS, PULSE_SHORT_MS, 3);
+        case CONTINUOUS: return CONTINUOUS_MS;
+        case INCREASING: return RAMP_MS;
+        case DECREASING: return RAMP_MS;
+        case ALTERNATING: return pulseTrainLength(PULSE_LONG_MS, PULSE_LONG_MS, 3);
+        case WAVE: return WAVE_MS;
+        default: return 0;
+    }
+}
+
+// Envelope in percent of full intensity `ms` into the pattern
+constexpr int waveformPercent(HapticPattern pattern, int ms) {
+    switch (pattern) {
+        case SINGLE_PULSE:
+        case CONTINUOUS:
+            return 100;
+        case DOUBLE_PULSE:
+            return ms % (2 * PULSE_MEDIUM_MS) < PULSE_MEDIUM_MS ? 100 : 0;
+        case TRIPLE_PULSE:
+            return ms % (2 * PULSE_SHORT_MS) < PULSE_SHORT_MS ? 100 : 0;
+        case ALTERNATING:
+            return ms % (2 * PULSE_LONG_MS) < PULSE_LONG_MS ? 100 : 0;
+        case INCREASING:
+            return RAMP_FLOOR_PERCENT + (100 - RAMP_FLOOR_PERCENT) * ms / (RAMP_MS - 1);
+        case DECREASING:
+            return 100 - (100 - RAMP_FLOOR_PERCENT) * ms / (RAMP_MS - 1);
+        case WAVE:
+            // Parabolic stand-in for a half sine: 4x(1 - x), peaking mid-wave
+            return 400 * ms * (WAVE_MS - ms) / (WAVE_MS * WAVE_MS);
+        default:
+            return 0;
+    }
+}
+
+template <HapticPattern Pattern, int Intensity>
+constexpr std::array<uint8_t, waveformLength(Pattern)> renderWaveform() {
+    std::array<uint8_t, waveformLength(Pattern)> duty{};
+    for (int ms = 0; ms < waveformLength(Pattern); ms++) {
+        duty[ms] = static_cast<uint8_t>((Intensity * waveformPercent(Pattern, ms) + 50) / 100);
+    }
+    return duty;
+}
+
+template <HapticPattern Pattern, int Intensity>
+constexpr std::array<uint8_t, waveformLength(Pattern)> WAVEFORM = renderWaveform<Pattern, Intensity>();
+
+struct WaveformTable {
+    const uint8_t* duty;  // PWM duty per millisecond
+    int length;
+};
+
+#define WAVEFORM_ROW(pattern)                                                   \
+    {{WAVEFORM<pattern, LIGHT>.data(), waveformLength(pattern)},                \
+     {WAVEFORM<pattern, MEDIUM>.data(), waveformLength(pattern)},               \
+     {WAVEFORM<pattern, STRONG>.data(), waveformLength(pattern)}}
+
+// Indexed by HapticPattern, then waveformLevel()
+constexpr WaveformTable WAVEFORMS[][WAVEFORM_INTENSITY_LEVELS] = {
+    {{nullptr, 0}, {nullptr, 0}, {nullptr, 0}},  // NONE
+    WAVEFORM_ROW(SINGLE_PULSE),
+    WAVEFORM_ROW(DOUBLE_PULSE),
+    WAVEFORM_ROW(TRIPLE_PULSE),
+    WAVEFORM_ROW(CONTINUOUS),
+    WAVEFORM_ROW(INCREASING),
+    WAVEFORM_ROW(DECREASING),
+    WAVEFORM_ROW(ALTERNATING),
+    WAVEFORM_ROW(WAVE),
+};
+
+#undef WAVEFORM_ROW
+
+static_assert(sizeof(WAVEFORMS) / sizeof(WAVEFORMS[0]) == WAVE + 1, "every HapticPattern needs a waveform");
+static_assert(WAVEFORM<WAVE, STRONG>[WAVE_MS / 2] == STRONG, "wave peaks at full intensity");
+static_assert(WAVEFORM<INCREASING, STRONG>[RAMP_MS - 1] == STRONG, "ramps reach full intensity");
+
+// Table row for an intensity, or -1 when it is not a FeedbackIntensity
+constexpr int waveformLevel(int intensity) {
+    return intensity == LIGHT ? 0 : intensity == MEDIUM ? 1 : intensity == STRONG ? 2 : -1;
+}
+
+// Duty `ms` into a pattern played at any intensity (0 past the end)
+inline int waveformDuty(HapticPattern pattern, int intensity, int ms) {
+    int level = waveformLevel(intensity);
+    const WaveformTable& table = WAVEFORMS[pattern][level < 0 ? WAVEFORM_INTENSITY_LEVELS - 1 : level];
+    if (ms < 0 || ms >= table.length) return 0;
+    return level < 0 ? table.duty[ms] * intensity / STRONG : table.duty[ms];
+}
+
+#endif // HAPTIC_WAVEFORMS_H
@@ -0,0 +1,193 @@
+/*
+ * Shared I2C Bus Arbiter for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "i2c_bus.h"
+#include "metrics.h"
+#include "span_trace.h"
+#include "trace_log.h"
+#include <algorithm>
+
+// Timing
+
+uint64_t i2cTransactionNs(uint32_t clockHz, I2cDirection direction, int length) {
+    // Address, register and data bytes each take 9 bits with the ACK;
+    // START and STOP take about a bit each, and a read adds a repeated
+    // START and the address again before its data
+    uint64_t bits = direction == I2C_READ ? 9ULL * (3 + length) + 3 : 9ULL * (2 + length) + 2;
+    return bits * 1000000000ULL / std::max<uint32_t>(clockHz, 1);
+}
+
+// Queues
+
+static bool sameRegisters(const I2cTransaction& a, int channel, int address, int reg) {
+    return a.channel == channel && a.address == address && a.reg == reg;
+}
+
+static I2cQueueResult pushTransaction(I2cBus* bus, I2cQueue* queue, const I2cTransaction& transaction) {
+    if (queue->count >= I2C_QUEUE_CAPACITY) {
+        incrementMetric(METRIC_I2C_REJECTED);
+        return I2C_REJECTED;
+    }
+    queue->entries[queue->count++] = transaction;
+    runI2cBus(bus, transaction.queuedNs);  // Straight out if the bus is free
+    return I2C_QUEUED;
+}
+
+static void removeTransaction(I2cQueue* queue, int index) {
+    std::copy(queue->entries + index + 1, queue->entries + queue->count, queue->entries + index);
+    queue->count--;
+}
+
+static I2cTransaction makeTransaction(I2cDirection direction, int channel, int address, int reg, int length,
+                                      const char* span, I2cCallback done, void* context) {
+    I2cTransaction transaction;
+    transaction.direction = direction;
+    transaction.channel = static_cast<int8_t>(channel);
+    transaction.address = static_cast<uint8_t>(address);
+    transaction.reg = static_cast<uint8_t>(reg);
+    transaction.length = static_cast<uint8_t>(length);
+    transaction.queuedNs = traceTimestampNs();
+    transaction.span = span;
+    transaction.done = done;
+    transaction.context = context;
+    transaction.merged = 0;
+    return transaction;
+}
+
+static bool validTransaction(int channel, int address, int reg, int length) {
+    return channel >= I2C_TRUNK && channel < I2C_MUX_CHANNELS && address >= 0 && address < 0x80 &&
+           reg >= 0 && reg <= 0xFF && length >= 0 && length <= 0xFF;
+}
+
+// Scheduling
+
+// Bus time for one transaction; returns when it ends
+static uint64_t driveBus(I2cBus* bus, uint64_t startNs, uint64_t durationNs, const char* span) {
+    recordSpan(span, startNs, durationNs);
+    bus->busyUntilNs = startNs + durationNs;
+    bus->busyNs += durationNs;
+    bus->windowBusyNs += durationNs;
+    bus->transactions++;
+    incrementMetric(METRIC_I2C_TRANSACTIONS);
+    return bus->busyUntilNs;
+}
+
+static bool due(const I2cQueue* queue, int index, uint64_t startNs) {
+    return index < queue->count && queue->entries[index].queuedNs <= startNs;
+}
+
+// Writes first, up to I2C_MAX_WRITE_STREAK while a read is waiting
+static bool takeWrite(I2cBus* bus, uint64_t startNs) {
+    if (!due(&bus->writes, 0, startNs)) return false;
+    return !due(&bus->reads, 0, startNs) || bus->writeStreak < I2C_MAX_WRITE_STREAK;
+}
+
+// Within the oldest read's batch, one that needs no mux select; reads
+// from later batches never pass it, so no channel waits for long
+static int chooseRead(const I2cBus* bus, uint64_t startNs) {
+    uint64_t batchEndNs = bus->reads.entries[0].queuedNs + I2C_READ_BATCH_NS;
+    for (int index = 0; due(&bus->reads, index, startNs) && bus->reads.entries[index].queuedNs <= batchEndNs;
+         index++) {
+        int channel = bus->reads.entries[index].channel;
+        if (channel == I2C_TRUNK || channel == bus->selectedChannel) return index;
+    }
+    return 0;
+}
+
+static void startTransaction(I2cBus* bus, const I2cTransaction& transaction, uint64_t startNs) {
+    if (transaction.channel != I2C_TRUNK && transaction.channel != bus->selectedChannel) {
+        startNs = driveBus(bus, startNs, i2cTransactionNs(bus->clockHz, I2C_WRITE, 0), "i2c_mux_select");
+        bus->selectedChannel = transaction.channel;
+    }
+    uint64_t durationNs = i2cTransactionNs(bus->clockHz, transaction.direction, transaction.length);
+    uint64_t endNs = driveBus(bus, startNs, durationNs, transaction.span);
+    if (transaction.done) transaction.done(bus, &transaction, endNs);
+}
+
+static void updateUtilization(I2cBus* bus, uint64_t nowNs) {
+    if (nowNs < bus->windowStartNs + I2C_UTILIZATION_WINDOW_NS) return;
+    uint64_t elapsedNs = nowNs - bus->windowStartNs;
+    bus->utilization = static_cast<int>(std::min<uint64_t>(100, bus->windowBusyNs * 100 / elapsedNs));
+    incrementMetric(METRIC_I2C_BUSY_US, bus->windowBusyNs / 1000);
+    bus->windowStartNs = nowNs;
+    bus->windowBusyNs = 0;
+}
+
+// Public API
+
+void initI2cBus(I2cBus* bus, uint32_t clockHz) {
+    bus->clockHz = clockHz;
+    bus->busyUntilNs = 0;
+    bus->selectedChannel = -1;
+    bus->writeStreak = 0;
+    bus->writes.count = 0;
+    bus->reads.count = 0;
+    bus->transactions = 0;
+    bus->busyNs = 0;
+    bus->windowStartNs = traceTimestampNs();
+    bus->windowBusyNs = 0;
+    bus->utilization = 0;
+}
+
+// A single-register write merges with the last one waiting for that
+// register, unless another write to the device comes after it, it reports
+// to a different callback, or it already holds I2C_MAX_MERGED others
+I2cQueueResult queueI2cWrite(I2cBus* bus, int channel, int address, int reg, int length, const char* span,
+                             I2cCallback done, void* context) {
+    if (!validTransaction(channel, address, reg, length)) return I2C_REJECTED;
+    if (length == 1) {
+        for (int index = bus->writes.count - 1; index >= 0; index--) {
+            I2cTransaction& waiting = bus->writes.entries[index];
+            if (waiting.channel != channel || waiting.address != address) continue;
+            if (waiting.reg == reg && waiting.length == 1 && waiting.done == done && waiting.context == context &&
+                waiting.merged < I2C_MAX_MERGED) {
+                waiting.mergedNs[waiting.merged++] = traceTimestampNs();
+                return I2C_MERGED;
+            }
+            break;
+        }
+    }
+    return pushTransaction(bus, &bus->writes,
+                           makeTransaction(I2C_WRITE, channel, address, reg, length, span, done, context));
+}
+
+I2cQueueResult queueI2cRead(I2cBus* bus, int channel, int address, int reg, int length, const char* span,
+                            I2cCallback done, void* context) {
+    if (!validTransaction(channel, address, reg, length)) return I2C_REJECTED;
+    for (int index = 0; index < bus->reads.count; index++) {
+        const I2cTransaction& waiting = bus->reads.entries[index];
+        if (sameRegisters(waiting, channel, address, reg) && waiting.length == length) return I2C_MERGED;
+    }
+    return pushTransaction(bus, &bus->reads,
+                           makeTransaction(I2C_READ, channel, address, reg, length, span, done, context));
+}
+
+uint64_t nextI2cStart(const I2cBus* bus) {
+    uint64_t queuedNs = UINT64_MAX;
+    if (bus->writes.count > 0) queuedNs = bus->writes.entries[0].queuedNs;
+    if (bus->reads.count > 0) queuedNs = std::min(queuedNs, bus->reads.entries[0].queuedNs);
+    return queuedNs == UINT64_MAX ? UINT64_MAX : std::max(queuedNs, bus->busyUntilNs);
+}
+
+// Each pass starts the transaction the bus would pick when it next frees
+// up, among those queued by then, until that start lies past nowNs
+void runI2cBus(I2cBus* bus, uint64_t nowNs) {
+    uint64_t startNs;
+    while ((startNs = nextI2cStart(bus)) <= nowNs) {
+        I2cTransaction transaction;
+        if (takeWrite(bus, startNs)) {
+            transaction = bus->writes.entries[0];
+            removeTransaction(&bus->writes, 0);
+            bus->writeStreak++;
+        } else {
+            int index = chooseRead(bus, startNs);
+            transaction = bus->reads.entries[index];
+            removeTransaction(&bus->reads, index);
+            bus->writeStreak = 0;
+        }
+        startTransaction(bus, transaction, startNs);
+    }
+    updateUtilization(bus, nowNs);
+}
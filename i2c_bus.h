@@ -0,0 +1,115 @@
+/*
+ * Shared I2C Bus Arbiter for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * One I2cBus per SDA/SCL pair. The DRV2605L drivers share an address,
+ * so they sit behind a TCA9548A mux on their pair; devices with free
+ * addresses sit on the trunk ahead of it. The pair also carries two IMUs
+ * (sensors.h), so sensor reads and haptic writes contend for it.
+ * Everything queues transactions here instead of owning a bus, and
+ * runI2cBus() plays them out on a simulated timeline: each transaction is
+ * timed at the bus clock, starts no earlier than it was queued or the bus
+ * frees up, and only starts once the clock has reached it. Running the
+ * bus late changes when the callbacks run, not the timeline they report.
+ * Nothing is sent anywhere.
+ *
+ * Writes go first, so a haptic duty change waits only for the transaction
+ * in flight, the writes ahead of it and at most one read per
+ * I2C_MAX_WRITE_STREAK writes; that read is what keeps a busy motor from
+ * starving sampling. Reads are burst reads of a register block. Within a
+ * batch (reads queued within I2C_READ_BATCH_NS of each other) those on the
+ * trunk or the selected mux channel go before one that needs a select, so
+ * a batch of sensor reads costs as few selects as possible. A read or
+ * single-register write that duplicates one still waiting is merged into
+ * it: a read returns whatever the registers hold when it runs, and a
+ * register write only needs its latest value. A merged write keeps its
+ * queue time in the transaction, so the callback can report its latency.
+ */
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <cstdint>
+
+// Bus Configuration
+const uint32_t I2C_STANDARD_MODE = 100000;  // Hz
+const uint32_t I2C_FAST_MODE = 400000;
+const uint32_t I2C_BUS_CLOCK = I2C_FAST_MODE;  // The MPU6050 tops out at fast mode
+const int I2C_MUX_ADDRESS = 0x70;           // TCA9548A
+const int I2C_MUX_CHANNELS = 8;
+const int I2C_TRUNK = -1;                   // Ahead of the mux: reachable whatever channel is selected
+
+// Arbiter Configuration
+const int I2C_QUEUE_CAPACITY = 32;          // Per direction
+const int I2C_MAX_WRITE_STREAK = 4;         // Writes before a waiting read goes
+const uint64_t I2C_READ_BATCH_NS = 100000;  // Reads queued this close together may be reordered
+const uint64_t I2C_UTILIZATION_WINDOW_NS = 1000000000;
+const int I2C_MAX_MERGED = 8;               // Writes folded into one; the next is queued
+
+enum I2cDirection : uint8_t {
+    I2C_WRITE,  // Register address, then the data
+    I2C_READ    // Register address, repeated START, then a burst of data
+};
+
+enum I2cQueueResult {
+    I2C_QUEUED,
+    I2C_MERGED,   // Into a transaction that was already waiting; a write's done still reports it
+    I2C_REJECTED  // Queue full
+};
+
+struct I2cBus;
+struct I2cTransaction;
+
+// Called when a transaction has been scheduled; endNs is when the last
+// byte is on the bus (traceTimestampNs clock)
+typedef void (*I2cCallback)(I2cBus* bus, const I2cTransaction* transaction, uint64_t endNs);
+
+struct I2cTransaction {
+    I2cDirection direction;
+    int8_t channel;     // Mux channel, or I2C_TRUNK
+    uint8_t address;
+    uint8_t reg;
+    uint8_t length;     // Data bytes
+    uint64_t queuedNs;
+    const char* span;   // Recorded as a span when it runs
+    I2cCallback done;
+    void* context;
+    uint8_t merged;     // Later writes folded into this one
+    uint64_t mergedNs[I2C_MAX_MERGED];  // When each of them was queued
+};
+
+struct I2cQueue {
+    I2cTransaction entries[I2C_QUEUE_CAPACITY];  // Oldest first
+    int count;
+
+    I2cQueue() : entries(), count(0) {}
+};
+
+struct I2cBus {
+    uint32_t clockHz;
+    uint64_t busyUntilNs;  // End of the last transaction scheduled
+    int selectedChannel;   // Mux channel, -1 before the first select
+    int writeStreak;
+    I2cQueue writes;
+    I2cQueue reads;
+    uint64_t transactions;
+    uint64_t busyNs;       // Total time the bus has been driven
+    uint64_t windowStartNs;
+    uint64_t windowBusyNs;
+    int utilization;       // Percent, over the last full window
+
+    I2cBus() : clockHz(I2C_FAST_MODE), busyUntilNs(0), selectedChannel(-1), writeStreak(0), writes(), reads(),
+               transactions(0), busyNs(0), windowStartNs(0), windowBusyNs(0), utilization(0) {}
+};
+
+// Function Declarations
+void initI2cBus(I2cBus* bus, uint32_t clockHz);
+uint64_t i2cTransactionNs(uint32_t clockHz, I2cDirection direction, int length);  // START to STOP, with ACKs
+I2cQueueResult queueI2cWrite(I2cBus* bus, int channel, int address, int reg, int length, const char* span,
+                             I2cCallback done = nullptr, void* context = nullptr);
+I2cQueueResult queueI2cRead(I2cBus* bus, int channel, int address, int reg, int length, const char* span,
+                            I2cCallback done = nullptr, void* context = nullptr);
+void runI2cBus(I2cBus* bus, uint64_t nowNs);  // Starts everything due by nowNs
+uint64_t nextI2cStart(const I2cBus* bus);     // UINT64_MAX when nothing is waiting
+
+#endif // I2C_BUS_H
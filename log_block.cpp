@@ -0,0 +1,341 @@
+/*
+ * Checksummed Log Block Format for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "log_block.h"
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <iterator>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <nmmintrin.h>
+#define CRC32C_HW_X86 1
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define CRC32C_HW_ARM 1
+#endif
+
+// CRC32C (Castagnoli), reflected polynomial
+const uint32_t CRC32C_POLY = 0x82F63B78;
+
+// Blocks are searched for in windows this large when the tail is torn
+const size_t LOG_RECOVERY_WINDOW = MAX_LOG_BLOCK_PAYLOAD + LOG_BLOCK_HEADER_SIZE +
+                                   LOG_BLOCK_TRAILER_SIZE;
+
+struct Crc32cTable {
+    uint32_t entries[256];
+
+    Crc32cTable() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLY : 0);
+            }
+            entries[i] = crc;
+        }
+    }
+};
+
+static uint32_t crc32cSoftware(const uint8_t* data, size_t length, uint32_t crc) {
+    static const Crc32cTable table;
+    while (length--) {
+        crc = table.entries[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#if defined(CRC32C_HW_X86)
+__attribute__((target("sse4.2")))
+static uint32_t crc32cHardware(const uint8_t* data, size_t length, uint32_t crc) {
+#if defined(__x86_64__)
+    uint64_t wide = crc;
+    while (length >= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        wide = _mm_crc32_u64(wide, word);
+        data += 8;
+        length -= 8;
+    }
+    crc = static_cast<uint32_t>(wide);
+#endif
+    while (length--) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+#elif defined(CRC32C_HW_ARM)
+static uint32_t crc32cHardware(const uint8_t* data, size_t length, uint32_t crc) {
+    while (length >= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = __crc32cd(crc, word);
+        data += 8;
+        length -= 8;
+    }
+    while (length--) {
+        crc = __crc32cb(crc, *data++);
+    }
+    return crc;
+}
+#endif
+
+bool crc32cHardwareAvailable() {
+#if defined(CRC32C_HW_X86)
+    static const bool available = __builtin_cpu_supports("sse4.2");
+    return available;
+#elif defined(CRC32C_HW_ARM)
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint32_t crc32c(const void* data, size_t length, uint32_t crc) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+#if defined(CRC32C_HW_X86) || defined(CRC32C_HW_ARM)
+    if (crc32cHardwareAvailable()) {
+        return ~crc32cHardware(bytes, length, crc);
+    }
+#endif
+    return ~crc32cSoftware(bytes, length, crc);
+}
+
+// Byte Encoding Helpers
+
+void putU16(std::vector<uint8_t>* out, uint16_t value) {
+    out->push_back(static_cast<uint8_t>(value));
+    out->push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void putU32(std::vector<uint8_t>* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out->push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void putU64(std::vector<uint8_t>* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out->push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void putDouble(std::vector<uint8_t>* out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putU64(out, bits);
+}
+
+void putFloat(std::vector<uint8_t>* out, double value) {
+    float narrow = static_cast<float>(value);
+    uint32_t bits;
+    std::memcpy(&bits, &narrow, sizeof(bits));
+    putU32(out, bits);
+}
+
+uint16_t getU16(const uint8_t* in) {
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+uint32_t getU32(const uint8_t* in) {
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+           (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+uint64_t getU64(const uint8_t* in) {
+    return static_cast<uint64_t>(getU32(in)) | (static_cast<uint64_t>(getU32(in + 4)) << 32);
+}
+
+double getFloat(const uint8_t* in) {
+    uint32_t bits = getU32(in);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+double getDouble(const uint8_t* in) {
+    uint64_t bits = getU64(in);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Block I/O
+
+static uint32_t blockChecksum(const uint8_t* lengthField, const uint8_t* payload, size_t length) {
+    uint32_t crc = crc32c(lengthField, 4);
+    return crc32c(payload, length, crc);
+}
+
+bool appendLogBlock(const std::string& filename, const void* payload, size_t length) {
+    if (length > MAX_LOG_BLOCK_PAYLOAD) return false;
+
+    // Assemble the whole frame first so it reaches the file in one write
+    std::vector<uint8_t> frame;
+    frame.reserve(LOG_BLOCK_HEADER_SIZE + length + LOG_BLOCK_TRAILER_SIZE);
+    putU32(&frame, LOG_BLOCK_MAGIC);
+    putU32(&frame, static_cast<uint32_t>(length));
+    putU32(&frame, blockChecksum(frame.data() + 4, static_cast<const uint8_t*>(payload), length));
+    frame.insert(frame.end(), static_cast<const uint8_t*>(payload),
+                 static_cast<const uint8_t*>(payload) + length);
+    putU32(&frame, static_cast<uint32_t>(length));
+    putU32(&frame, LOG_BLOCK_END_MAGIC);
+
+    std::ofstream file(filename, std::ios::binary | std::ios::app);
+    if (!file) return false;
+    file.write(reinterpret_cast<const char*>(frame.data()), frame.size());
+    file.flush();
+    return file.good();
+}
+
+// Checks the block whose trailer ends at 'end'; stores its start offset on success
+static bool blockEndsAt(std::ifstream& file, unsigned long end, unsigned long* start) {
+    if (end < LOG_BLOCK_HEADER_SIZE + LOG_BLOCK_TRAILER_SIZE) return false;
+
+    uint8_t trailer[LOG_BLOCK_TRAILER_SIZE];
+    file.clear();
+    file.seekg(end - LOG_BLOCK_TRAILER_SIZE);
+    if (!file.read(reinterpret_cast<char*>(trailer), sizeof(trailer))) return false;
+
+    uint32_t length = getU32(trailer);
+    if (getU32(trailer + 4) != LOG_BLOCK_END_MAGIC || length > MAX_LOG_BLOCK_PAYLOAD) return false;
+
+    unsigned long frameSize = LOG_BLOCK_HEADER_SIZE + length + LOG_BLOCK_TRAILER_SIZE;
+    if (frameSize > end) return false;
+
+    std::vector<uint8_t> block(LOG_BLOCK_HEADER_SIZE + length);
+    file.seekg(end - frameSize);
+    if (!file.read(reinterpret_cast<char*>(block.data()), block.size())) return false;
+
+    if (getU32(block.data()) != LOG_BLOCK_MAGIC || getU32(block.data() + 4) != length) return false;
+    if (getU32(block.data() + 8) != blockChecksum(block.data() + 4, block.data() + LOG_BLOCK_HEADER_SIZE, length)) {
+        return false;
+    }
+
+    *start = end - frameSize;
+    return true;
+}
+
+bool readLogBlocks(const std::string& filename, std::vector<std::vector<uint8_t>>* blocks) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) return false;
+
+    uint8_t header[LOG_BLOCK_HEADER_SIZE];
+    while (file.read(reinterpret_cast<char*>(header), sizeof(header))) {
+        uint32_t length = getU32(header + 4);
+        if (getU32(header) != LOG_BLOCK_MAGIC || length > MAX_LOG_BLOCK_PAYLOAD) return false;
+
+        std::vector<uint8_t> payload(length);
+        uint8_t trailer[LOG_BLOCK_TRAILER_SIZE];
+        if (!file.read(reinterpret_cast<char*>(payload.data()), length) ||
+            !file.read(reinterpret_cast<char*>(trailer), sizeof(trailer))) {
+            return false;
+        }
+        if (getU32(header + 8) != blockChecksum(header + 4, payload.data(), length) ||
+            getU32(trailer) != length || getU32(trailer + 4) != LOG_BLOCK_END_MAGIC) {
+            return false;
+        }
+        blocks->push_back(std::move(payload));
+    }
+    return file.eof() && file.gcount() == 0;
+}
+
+// Checks the frame starting at 'offset'; stores its size on success
+static bool blockStartsAt(const std::vector<uint8_t>& data, size_t offset, size_t* frameSize) {
+    if (data.size() - offset < LOG_BLOCK_HEADER_SIZE + LOG_BLOCK_TRAILER_SIZE) return false;
+
+    const uint8_t* header = data.data() + offset;
+    uint32_t length = getU32(header + 4);
+    if (getU32(header) != LOG_BLOCK_MAGIC || length > MAX_LOG_BLOCK_PAYLOAD) return false;
+    if (data.size() - offset - LOG_BLOCK_HEADER_SIZE - LOG_BLOCK_TRAILER_SIZE < length) return false;
+
+    const uint8_t* trailer = header + LOG_BLOCK_HEADER_SIZE + length;
+    if (getU32(trailer) != length || getU32(trailer + 4) != LOG_BLOCK_END_MAGIC) return false;
+    if (getU32(header + 8) != blockChecksum(header + 4, header + LOG_BLOCK_HEADER_SIZE, length)) return false;
+
+    *frameSize = LOG_BLOCK_HEADER_SIZE + length + LOG_BLOCK_TRAILER_SIZE;
+    return true;
+}
+
+bool readIntactLogBlocks(const std::string& filename, std::vector<std::vector<uint8_t>>* blocks,
+                         size_t* skipped) {
+    *skipped = 0;
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) return false;
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // A damaged frame counts once; reading resumes at the next intact header
+    size_t offset = 0;
+    bool inDamage = false;
+    while (offset < data.size()) {
+        size_t frameSize = 0;
+        if (blockStartsAt(data, offset, &frameSize)) {
+            const uint8_t* payload = data.data() + offset + LOG_BLOCK_HEADER_SIZE;
+            blocks->emplace_back(payload, payload + frameSize - LOG_BLOCK_HEADER_SIZE - LOG_BLOCK_TRAILER_SIZE);
+            offset += frameSize;
+            inDamage = false;
+            continue;
+        }
+        if (!inDamage) (*skipped)++;
+        inDamage = true;
+        offset++;
+    }
+    return true;
+}
+
+bool recoverLogFile(const std::string& filename, LogRecoveryResult* result) {
+    std::error_code error;
+    unsigned long fileSize = std::filesystem::file_size(filename, error);
+    if (error) return false;
+
+    result->fileSize = fileSize;
+    result->validSize = 0;
+    result->bytesScanned = 0;
+    result->truncated = false;
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) return false;
+
+    // Fast path: the last block is intact, nothing to do
+    unsigned long start = 0;
+    if (fileSize == 0 || blockEndsAt(file, fileSize, &start)) {
+        result->validSize = fileSize;
+        result->bytesScanned = fileSize == 0 ? 0 : fileSize - start;
+        return true;
+    }
+
+    // Torn tail: search backwards for the end marker of an intact block.
+    // A torn block is never larger than one frame, so the first window
+    // almost always contains the answer.
+    std::vector<uint8_t> window;
+    unsigned long windowEnd = fileSize;
+    bool found = false;
+    while (windowEnd > 0 && !found) {
+        unsigned long windowStart = windowEnd > LOG_RECOVERY_WINDOW ? windowEnd - LOG_RECOVERY_WINDOW : 0;
+        // Overlap by the marker size so markers straddling windows are seen
+        unsigned long readEnd = windowEnd + 3 < fileSize ? windowEnd + 3 : fileSize;
+        window.resize(readEnd - windowStart);
+        file.clear();
+        file.seekg(windowStart);
+        if (!file.read(reinterpret_cast<char*>(window.data()), window.size())) return false;
+        result->bytesScanned += windowEnd - windowStart;
+
+        for (unsigned long end = readEnd; end >= windowStart + 4; end--) {
+            if (getU32(window.data() + (end - 4 - windowStart)) != LOG_BLOCK_END_MAGIC) continue;
+            if (blockEndsAt(file, end, &start)) {
+                result->validSize = end;
+                found = true;
+                break;
+            }
+        }
+        windowEnd = windowStart;
+    }
+
+    file.close();
+    std::filesystem::resize_file(filename, result->validSize, error);
+    if (error) return false;
+    result->truncated = true;
+    return true;
+}
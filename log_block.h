@@ -0,0 +1,60 @@
+/*
+ * Checksummed Log Block Format for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Every record written to storage is framed as
+ *   [magic][length][crc32c] payload [length][end magic]
+ * The trailer lets recovery walk backwards from the end of the file, so a
+ * torn write after a brown-out is found without reading the whole log.
+ */
+
+#ifndef LOG_BLOCK_H
+#define LOG_BLOCK_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Block Framing
+const uint32_t LOG_BLOCK_MAGIC = 0x4B4C4248;      // "HBLK"
+const uint32_t LOG_BLOCK_END_MAGIC = 0x444E4548;  // "HEND"
+const size_t LOG_BLOCK_HEADER_SIZE = 12;          // magic, length, crc
+const size_t LOG_BLOCK_TRAILER_SIZE = 8;          // length, end magic
+const size_t MAX_LOG_BLOCK_PAYLOAD = 64 * 1024;
+
+// Result of a tail recovery pass
+struct LogRecoveryResult {
+    unsigned long fileSize;
+    unsigned long validSize;     // Offset just past the last valid block
+    unsigned long bytesScanned;  // Bytes read while searching the tail
+    bool truncated;
+
+    LogRecoveryResult() : fileSize(0), validSize(0), bytesScanned(0),
+                          truncated(false) {}
+};
+
+// Checksum Functions
+uint32_t crc32c(const void* data, size_t length, uint32_t crc = 0);
+bool crc32cHardwareAvailable();
+
+// Block I/O Functions
+bool appendLogBlock(const std::string& filename, const void* payload, size_t length);
+bool readLogBlocks(const std::string& filename, std::vector<std::vector<uint8_t>>* blocks);  // Fails on any bad block
+bool readIntactLogBlocks(const std::string& filename, std::vector<std::vector<uint8_t>>* blocks,
+                         size_t* skipped);  // Skips and counts damaged blocks
+bool recoverLogFile(const std::string& filename, LogRecoveryResult* result);
+
+// Byte Encoding Helpers (little-endian on disk)
+void putU16(std::vector<uint8_t>* out, uint16_t value);
+void putU32(std::vector<uint8_t>* out, uint32_t value);
+void putU64(std::vector<uint8_t>* out, uint64_t value);
+void putDouble(std::vector<uint8_t>* out, double value);
+void putFloat(std::vector<uint8_t>* out, double value);
+uint16_t getU16(const uint8_t* in);
+uint32_t getU32(const uint8_t* in);
+uint64_t getU64(const uint8_t* in);
+double getDouble(const uint8_t* in);
+double getFloat(const uint8_t* in);
+
+#endif // LOG_BLOCK_H
@@ -12,15 +12,21 @@
  */
 
 #include <iostream>
-#include <vector>
 #include <chrono>
 #include <thread>
-#include <cmath>
+#include <cstdlib>
 #include <string>
-#include <fstream>
+#include <ctime>
 #include "sensors.h"
 #include "haptic.h"
 #include "data_logger.h"
+#include "trace_log.h"
+#include "metrics.h"
+#include "span_trace.h"
+#include "sim_random.h"
+#include "alloc_tracker.h"
+#include "trainer_context.h"
+#include "trainer_loop.h"
 
 // Pin Definitions (for ESP32 reference)
 #define BNO055_SDA 21
@@ -36,82 +42,56 @@
 #define CALIB_BUTTON 5
 #define LED_PIN 2
 
-// System States
-enum SystemState {
-    STANDBY,
-    CALIBRATION,
-    TRAINING,
-    DATA_REVIEW
-};
+// Global Variables (per-athlete state lives in TrainerContext)
+TrainerHub trainerHub;
 
-// Basketball-specific data structures
-struct FreeThrowData {
-    double elbowAngle;
-    double wristAngle;
-    double releaseTiming;
-    double followThrough;
-    double bodyBalance;
-    bool wasSuccessful;
-    unsigned long shotDuration;
-    double peakAcceleration;
-};
-
-struct CalibrationData {
-    double avgElbowAngle;
-    double avgWristAngle;
-    double avgReleaseTiming;
-    double avgFollowThrough;
-    double avgBodyBalance;
-    double stdDevElbow;
-    double stdDevWrist;
-    double stdDevTiming;
-    bool isValid;
-};
-
-// Global Variables
-SystemState currentState = STANDBY;
-FreeThrowData currentShot;
-CalibrationData calibrationData;
-bool isCalibrated = false;
-int shotCount = 0;
-unsigned long lastShotTime = 0;
-
-// Basketball-specific thresholds
-const double ELBOW_ANGLE_TOLERANCE = 5.0;  // degrees
-const double WRIST_ANGLE_TOLERANCE = 3.0;  // degrees
-const double RELEASE_TIMING_TOLERANCE = 0.1;  // seconds
-const double SHOT_DURATION_MIN = 1.2;  // seconds
-const double SHOT_DURATION_MAX = 1.8;  // seconds
-
-// Function declarations
+// Function declarations (the per-athlete loop is in trainer_loop.h)
 void setup();
-void loop();
-void checkButtons();
-void handleStandby();
-void handleCalibration();
-void handleTraining();
-void handleDataReview();
-bool detectShotMotion();
-FreeThrowData analyzeShotForm();
-void provideHapticFeedback(const FreeThrowData& shotData);
-void readAllSensors();
-void printSensorData();
-void cycleSystemState();
-void recordShotOutcome();
-void monitorBattery();
-unsigned long millis();
+void printRunSummary(int seconds, double cpuSeconds);
 
-int main() {
+// Usage: basketball_trainer [athletes] [seconds]
+// With seconds, runs that long, stops and prints what the run cost
+int main(int argc, char* argv[]) {
     std::cout << "Basketball Free Throw Haptic Training System - C++ Version" << std::endl;
     
+    int athletes = argc > 1 ? std::atoi(argv[1]) : 1;
+    int seconds = argc > 2 ? std::atoi(argv[2]) : 0;
+    if (seconds < 0) {
+        std::cout << "Usage: basketball_trainer [athletes] [seconds]" << std::endl;
+        return 1;
+    }
+    
     setup();
+    std::clock_t cpuStart = std::clock();
     
-    // Main program loop
+    // Each athlete is stepped by a hub shard at its own adaptive sample rate
+    if (!startTrainerHub(&trainerHub, athletes, setupTrainer, trainerStep, SIM_DEFAULT_SEED)) {
+        std::cout << "Athlete count must be 1 to " << MAX_ATHLETES << std::endl;
+        return 1;
+    }
+    std::cout << "Training " << athletes << " athlete(s) on " << trainerHub.shards.size()
+              << " shard(s)" << std::endl;
+    
+    if (seconds > 0) {
+        std::this_thread::sleep_for(std::chrono::seconds(seconds));
+        stopTrainerHub(&trainerHub);
+        for (const std::unique_ptr<TrainerContext>& trainer : trainerHub.trainers) {
+            flushShotRecord(trainer.get());  // A last shot still waiting for its outcome
+        }
+        printRunSummary(seconds, static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC);
+        stopMetricsServer();
+        stopDataLogger();
+        stopTraceLogger();
+        return 0;
+    }
+    
+    // Block until SIGUSR1 asks for a trace; the shards do all the work
     while (true) {
-        loop();
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        waitForTraceDumpRequest();
+        dumpChromeTrace();
     }
     
+    stopTrainerHub(&trainerHub);
     return 0;
 }
 
@@ -123,6 +103,16 @@ void setup() {
     initHapticSystem();
     initDataLogger();
     
+    setSimulationSeed(SIM_DEFAULT_SEED);
+    setSimulationStream(simStream(SIM_STREAM_THREAD, 0));
+    setAllocationPolicy(ALLOC_POLICY_ABORT);  // Enforced when built with TRACK_ALLOCATIONS
+    startTraceLogger();
+    setSpanThreadName("main");
+    installTraceDumpSignal();
+    if (!startMetricsServer()) {
+        std::cout << "Metrics endpoint unavailable" << std::endl;
+    }
+    
     std::cout << "System initialized successfully!" << std::endl;
     std::cout << "Ready for basketball training!" << std::endl;
     
@@ -135,238 +125,34 @@ void setup() {
     }
 }
 
-void loop() {
-    // Check button states
-    checkButtons();
-    
-    // Update system based on current state
-    switch (currentState) {
-        case STANDBY:
-            handleStandby();
-            break;
-        case CALIBRATION:
-            handleCalibration();
-            break;
-        case TRAINING:
-            handleTraining();
-            break;
-        case DATA_REVIEW:
-            handleDataReview();
-            break;
-    }
-    
-    // Monitor battery
-    monitorBattery();
-}
-
-void checkButtons() {
-    static unsigned long lastButtonCheck = 0;
-    unsigned long currentTime = millis();
-    
-    if (currentTime - lastButtonCheck < 50) return;  // Debounce
-    
-    // Simulate button presses for testing
-    // In real implementation, read GPIO pins
-    
-    lastButtonCheck = currentTime;
-}
-
-void handleStandby() {
-    // Simulate slow blink LED
-    static unsigned long lastBlink = 0;
-    unsigned long currentTime = millis();
-    
-    if (currentTime - lastBlink > 1000) {
-        std::cout << "Status: STANDBY (LED blink)" << std::endl;
-        lastBlink = currentTime;
-    }
-    
-    // Read sensors for monitoring
-    readAllSensors();
-    
-    // Print sensor data every 2 seconds
-    static unsigned long lastPrint = 0;
-    if (currentTime - lastPrint > 2000) {
-        printSensorData();
-        lastPrint = currentTime;
-    }
-}
-
-void handleCalibration() {
-    std::cout << "Calibration Mode: Take 10 successful free throws" << std::endl;
-    
-    static int calibrationShots = 0;
-    static double elbowSum = 0, wristSum = 0, timingSum = 0;
-    
-    if (detectShotMotion()) {
-        calibrationShots++;
-        
-        // Collect data for this shot
-        FreeThrowData shotData = analyzeShotForm();
-        elbowSum += shotData.elbowAngle;
-        wristSum += shotData.wristAngle;
-        timingSum += shotData.releaseTiming;
-        
-        std::cout << "Calibration shot " << calibrationShots << " recorded" << std::endl;
-        
-        // Provide haptic feedback
-        triggerHapticFeedback(HAPTIC_1_PIN, STRONG, 100);
-        
-        if (calibrationShots >= 10) {
-            // Calculate averages
-            calibrationData.avgElbowAngle = elbowSum / 10.0;
-            calibrationData.avgWristAngle = wristSum / 10.0;
-            calibrationData.avgReleaseTiming = timingSum / 10.0;
-            calibrationData.isValid = true;
-            isCalibrated = true;
-            
-            std::cout << "Calibration complete!" << std::endl;
-            std::cout << "Average elbow angle: " << calibrationData.avgElbowAngle << std::endl;
-            
-            currentState = STANDBY;
-            calibrationShots = 0;
-            elbowSum = wristSum = timingSum = 0;
-        }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(2000));  // Wait between shots
-    }
-}
-
-void handleTraining() {
-    if (!isCalibrated) {
-        std::cout << "Please calibrate first!" << std::endl;
-        currentState = STANDBY;
+static void printStageLatency(const char* name, MetricStage stage, const char* unit) {
+    uint64_t count = stageLatencyCount(stage);
+    std::cout << name << ": ";
+    if (count == 0) {
+        std::cout << "no " << unit << std::endl;
         return;
     }
-    
-    if (detectShotMotion()) {
-        FreeThrowData shotData = analyzeShotForm();
-        provideHapticFeedback(shotData);
-        
-        shotCount++;
-        lastShotTime = millis();
-        
-        std::cout << "Shot analyzed - check form feedback" << std::endl;
-    }
+    std::cout << "p99 <= " << stageLatencyQuantileUs(stage, 0.99) << " us over " << count << " " << unit << std::endl;
 }
 
-void handleDataReview() {
-    std::cout << "Data Review Mode" << std::endl;
-    std::cout << "Total shots: " << shotCount << std::endl;
-    
-    if (isCalibrated) {
-        std::cout << "Calibrated elbow angle: " << calibrationData.avgElbowAngle << std::endl;
+// Process CPU covers every thread, the logger and metrics server included
+void printRunSummary(int seconds, double cpuSeconds) {
+    std::cout << "Ran " << trainerHub.trainers.size() << " athlete(s) for " << seconds << " s" << std::endl;
+    for (const std::unique_ptr<TrainerShard>& shard : trainerHub.shards) {
+        std::cout << "Shard " << shard->index << ": " << shard->trainers.size() << " athlete(s), "
+                  << shard->steps.load() << " steps, " << shard->wakeups.load() << " wakeups" << std::endl;
     }
-    
-    std::this_thread::sleep_for(std::chrono::milliseconds(5000));
-    currentState = STANDBY;
-}
-
-bool detectShotMotion() {
-    // Simulate motion detection
-    // In real implementation, read from BNO055
-    static double lastAccel = 0;
-    double currentAccel = 9.8 + (rand() % 100) / 10.0;  // Simulate sensor reading
-    
-    bool motionDetected = std::abs(currentAccel - lastAccel) > 5.0;
-    lastAccel = currentAccel;
-    
-    return motionDetected;
-}
-
-FreeThrowData analyzeShotForm() {
-    FreeThrowData shotData;
-    
-    // Simulate sensor readings and calculations
-    shotData.elbowAngle = 90.0 + (rand() % 20) - 10;  // 80-100 degrees
-    shotData.wristAngle = 45.0 + (rand() % 10) - 5;   // 40-50 degrees
-    shotData.releaseTiming = 1.5 + (rand() % 100) / 1000.0;  // 1.4-1.6 seconds
-    shotData.followThrough = 0.8 + (rand() % 40) / 100.0;    // 0.8-1.2
-    shotData.peakAcceleration = 15.0 + (rand() % 10);
-    
-    return shotData;
-}
-
-void provideHapticFeedback(const FreeThrowData& shotData) {
-    // Compare with calibration data
-    double elbowError = std::abs(shotData.elbowAngle - calibrationData.avgElbowAngle);
-    double wristError = std::abs(shotData.wristAngle - calibrationData.avgWristAngle);
-    
-    // Provide feedback based on errors
-    if (elbowError > ELBOW_ANGLE_TOLERANCE) {
-        triggerHapticFeedback(HAPTIC_1_PIN, STRONG, 300);
-        std::cout << "Haptic: Elbow angle correction needed" << std::endl;
-    } else if (wristError > WRIST_ANGLE_TOLERANCE) {
-        triggerHapticFeedback(HAPTIC_3_PIN, MEDIUM, 150);
-        std::cout << "Haptic: Wrist angle correction needed" << std::endl;
+    std::cout << "CPU: " << cpuSeconds * 1000 << " ms (" << 100.0 * cpuSeconds / seconds << "% of one core)"
+              << std::endl;
+    std::cout << "IMU samples: " << metricValue(METRIC_SAMPLES_READ) << " read, "
+              << metricValue(METRIC_SAMPLES_DROPPED) << " dropped" << std::endl;
+    printStageLatency("Sensor bus", STAGE_SENSOR_BUS, "reads");
+    printStageLatency("Haptic actuation", STAGE_HAPTIC_ACTUATION, "writes");
+    if (allocationTrackingEnabled()) {
+        AllocationCounts training = stateAllocationCounts(TRAINING);
+        std::cout << "Allocations in TRAINING: " << training.allocations << " (" << training.critical
+                  << " in guarded sections)" << std::endl;
     } else {
-        triggerPatternFeedback(ALL_ZONES, DOUBLE_PULSE, LIGHT);
-        std::cout << "Haptic: Good form!" << std::endl;
+        std::cout << "Allocations: not tracked (make debug)" << std::endl;
     }
 }
-
-void readAllSensors() {
-    // Simulate reading all sensors
-    // In real implementation, read from I2C devices
-}
-
-void printSensorData() {
-    // Simulate sensor data output
-    std::cout << "BNO055 - X: " << (rand() % 360) 
-              << " Y: " << (rand() % 360) 
-              << " Z: " << (rand() % 360) << std::endl;
-    
-    std::cout << "MPU6050 - AX: " << (rand() % 1000) 
-              << " AY: " << (rand() % 1000) 
-              << " AZ: " << (rand() % 1000) << std::endl;
-}
-
-void cycleSystemState() {
-    switch (currentState) {
-        case STANDBY:
-            currentState = TRAINING;
-            std::cout << "Switched to Training Mode" << std::endl;
-            break;
-        case TRAINING:
-            currentState = DATA_REVIEW;
-            std::cout << "Switched to Data Review Mode" << std::endl;
-            break;
-        case DATA_REVIEW:
-            currentState = STANDBY;
-            std::cout << "Switched to Standby Mode" << std::endl;
-            break;
-        case CALIBRATION:
-            // Can't switch out of calibration mode
-            break;
-    }
-}
-
-void recordShotOutcome() {
-    std::cout << "Shot outcome recorded" << std::endl;
-    triggerHapticFeedback(HAPTIC_2_PIN, LIGHT, 100);
-}
-
-void monitorBattery() {
-    static unsigned long lastBatteryCheck = 0;
-    unsigned long currentTime = millis();
-    
-    if (currentTime - lastBatteryCheck > 30000) {  // Check every 30 seconds
-        double voltage = 3.7 + (rand() % 10) / 100.0;  // Simulate battery voltage
-        
-        std::cout << "Battery voltage: " << voltage << "V" << std::endl;
-        
-        if (voltage < 3.2) {
-            std::cout << "Low battery warning!" << std::endl;
-        }
-        
-        lastBatteryCheck = currentTime;
-    }
-}
-
-// Utility function to simulate Arduino millis()
-unsigned long millis() {
-    static auto start = std::chrono::steady_clock::now();
-    auto now = std::chrono::steady_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - start);
-    return duration.count();
-}
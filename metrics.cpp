@@ -0,0 +1,264 @@
+/*
+ * Live Pipeline Metrics for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "metrics.h"
+#include "trace_log.h"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define METRICS_HAVE_UNIX_SOCKETS 1
+#endif
+
+// Histogram bucket upper bounds in microseconds (+Inf is implicit)
+const uint64_t LATENCY_BUCKETS_US[] = {10, 50, 100, 500, 1000, 5000, 10000, 50000, 100000};
+const int LATENCY_BUCKET_COUNT = sizeof(LATENCY_BUCKETS_US) / sizeof(LATENCY_BUCKETS_US[0]);
+
+const int METRICS_CLIENT_TIMEOUT_MS = 100;  // A scraper that never sends is dropped after this
+
+struct MetricInfo {
+    const char* name;
+    const char* help;
+};
+
+static const MetricInfo COUNTER_INFO[METRIC_COUNTER_COUNT] = {
+    {"trainer_samples_read_total", "IMU samples read"},
+    {"trainer_samples_dropped_total", "IMU samples missed because the loop overran or the I2C bus fell behind"},
+    {"trainer_shots_detected_total", "Shots detected in calibration or training"},
+    {"trainer_haptic_commands_total", "Haptic commands started, per zone"},
+    {"trainer_loop_overruns_total", "Loop iterations longer than one sample period"},
+    {"trainer_critical_allocations_total", "Heap allocations inside a no-allocation section"},
+    {"trainer_haptic_coalesced_total", "Zone haptic commands superseded by another in the same step"},
+    {"trainer_haptic_rejected_total", "Haptic commands refused by a full queue or a higher-priority zone"},
+    {"trainer_i2c_transactions_total", "I2C transactions on the simulated sensor and haptic buses"},
+    {"trainer_i2c_rejected_total", "I2C transactions refused by a full bus queue"},
+    {"trainer_i2c_busy_microseconds_total", "Time the simulated I2C buses have been driven"},
+};
+
+static const MetricInfo GAUGE_INFO[METRIC_GAUGE_COUNT] = {
+    {"trainer_log_queue_depth", "Trace records waiting to be formatted"},
+    {"trainer_system_state", "Current SystemState"},
+    {"trainer_sample_rate_hz", "Current IMU sample rate"},
+    {"trainer_i2c_utilization_percent", "Busiest I2C bus time in use over the last second"},
+};
+
+static const char* const STAGE_NAMES[METRIC_STAGE_COUNT] = {
+    "loop", "sensor_read", "shot_analysis", "haptic_feedback", "haptic_queue", "haptic_actuation",
+    "sensor_bus",
+};
+
+struct StageHistogram {
+    std::atomic<uint64_t> buckets[LATENCY_BUCKET_COUNT + 1];  // Last is +Inf
+    std::atomic<uint64_t> sumNs;
+    std::atomic<uint64_t> count;
+};
+
+static std::atomic<uint64_t> counters[METRIC_COUNTER_COUNT];
+static std::atomic<int64_t> gauges[METRIC_GAUGE_COUNT];
+static StageHistogram histograms[METRIC_STAGE_COUNT];
+
+static std::thread serverThread;
+static std::atomic<bool> serverRunning(false);
+
+ScopedStageTimer::ScopedStageTimer(MetricStage s) : stage(s), startNs(traceTimestampNs()) {}
+
+ScopedStageTimer::~ScopedStageTimer() {
+    recordStageLatency(stage, traceTimestampNs() - startNs);
+}
+
+void incrementMetric(MetricCounter counter, uint64_t amount) {
+    counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void setGauge(MetricGauge gauge, int64_t value) {
+    gauges[gauge].store(value, std::memory_order_relaxed);
+}
+
+void recordStageLatency(MetricStage stage, uint64_t nanoseconds) {
+    StageHistogram& histogram = histograms[stage];
+    uint64_t microseconds = nanoseconds / 1000;
+    int bucket = 0;
+    while (bucket < LATENCY_BUCKET_COUNT && microseconds > LATENCY_BUCKETS_US[bucket]) {
+        bucket++;
+    }
+    histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    histogram.sumNs.fetch_add(nanoseconds, std::memory_order_relaxed);
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t metricValue(MetricCounter counter) {
+    return counters[counter].load(std::memory_order_relaxed);
+}
+
+uint64_t stageLatencyCount(MetricStage stage) {
+    return histograms[stage].count.load(std::memory_order_relaxed);
+}
+
+uint64_t stageLatencyQuantileUs(MetricStage stage, double quantile) {
+    const StageHistogram& histogram = histograms[stage];
+    uint64_t rank = static_cast<uint64_t>(std::ceil(quantile * histogram.count.load(std::memory_order_relaxed)));
+    uint64_t cumulative = 0;
+    for (int bucket = 0; bucket < LATENCY_BUCKET_COUNT; bucket++) {
+        cumulative += histogram.buckets[bucket].load(std::memory_order_relaxed);
+        if (cumulative >= rank) return LATENCY_BUCKETS_US[bucket];
+    }
+    return UINT64_MAX;
+}
+
+void renderPrometheusMetrics(std::string* out) {
+    setGauge(GAUGE_LOG_QUEUE_DEPTH, static_cast<int64_t>(traceQueueDepth()));
+
+    char line[256];
+    out->clear();
+    for (int i = 0; i < METRIC_COUNTER_COUNT; i++) {
+        std::snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s counter\n%s %llu\n",
+                      COUNTER_INFO[i].name, COUNTER_INFO[i].help, COUNTER_INFO[i].name, COUNTER_INFO[i].name,
+                      static_cast<unsigned long long>(counters[i].load(std::memory_order_relaxed)));
+        out->append(line);
+    }
+    for (int i = 0; i < METRIC_GAUGE_COUNT; i++) {
+        std::snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s gauge\n%s %lld\n",
+                      GAUGE_INFO[i].name, GAUGE_INFO[i].help, GAUGE_INFO[i].name, GAUGE_INFO[i].name,
+                      static_cast<long long>(gauges[i].load(std::memory_order_relaxed)));
+        out->append(line);
+    }
+
+    out->append("# HELP trainer_stage_latency_seconds Pipeline stage latency\n"
+                "# TYPE trainer_stage_latency_seconds histogram\n");
+    for (int stage = 0; stage < METRIC_STAGE_COUNT; stage++) {
+        const StageHistogram& histogram = histograms[stage];
+        uint64_t cumulative = 0;
+        for (int bucket = 0; bucket <= LATENCY_BUCKET_COUNT; bucket++) {
+            cumulative += histogram.buckets[bucket].load(std::memory_order_relaxed);
+            if (bucket < LATENCY_BUCKET_COUNT) {
+                std::snprintf(line, sizeof(line),
+                              "trainer_stage_latency_seconds_bucket{stage=\"%s\",le=\"%g\"} %llu\n",
+                              STAGE_NAMES[stage], LATENCY_BUCKETS_US[bucket] / 1e6,
+                              static_cast<unsigned long long>(cumulative));
+            } else {
+                std::snprintf(line, sizeof(line),
+                              "trainer_stage_latency_seconds_bucket{stage=\"%s\",le=\"+Inf\"} %llu\n",
+                              STAGE_NAMES[stage], static_cast<unsigned long long>(cumulative));
+            }
+            out->append(line);
+        }
+        std::snprintf(line, sizeof(line),
+                      "trainer_stage_latency_seconds_sum{stage=\"%s\"} %.9f\n"
+                      "trainer_stage_latency_seconds_count{stage=\"%s\"} %llu\n",
+                      STAGE_NAMES[stage], histogram.sumNs.load(std::memory_order_relaxed) / 1e9,
+                      STAGE_NAMES[stage], static_cast<unsigned long long>(histogram.count.load(std::memory_order_relaxed)));
+        out->append(line);
+    }
+}
+
+#if defined(METRICS_HAVE_UNIX_SOCKETS)
+
+static void serveClient(int client) {
+    // The request itself is ignored; every connection gets a full scrape.
+    // Wait briefly for it so a silent client cannot stall the server thread
+    pollfd request = {};
+    request.fd = client;
+    request.events = POLLIN;
+    if (poll(&request, 1, METRICS_CLIENT_TIMEOUT_MS) <= 0) {
+        close(client);
+        return;
+    }
+    char buffer[1024];
+    ssize_t ignored = read(client, buffer, sizeof(buffer));
+    (void)ignored;
+
+    std::string body;
+    renderPrometheusMetrics(&body);
+
+    char header[128];
+    int headerLength = std::snprintf(header, sizeof(header),
+                                     "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                                     "Content-Length: %zu\r\n\r\n", body.size());
+    std::string response(header, headerLength);
+    response += body;
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t written = write(client, response.data() + sent, response.size() - sent);
+        if (written <= 0) break;
+        sent += written;
+    }
+    close(client);
+}
+
+static int stopPipe[2] = {-1, -1};  // Written by stopMetricsServer() to end the poll
+
+static void metricsServerLoop(int listener) {
+#if defined(__linux__)
+    // Only run when nothing else on the core wants to
+    sched_param param = {};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+
+    // Sleeps in poll until a scrape or shutdown; no periodic wakeups
+    pollfd descriptors[2] = {};
+    descriptors[0].fd = listener;
+    descriptors[0].events = POLLIN;
+    descriptors[1].fd = stopPipe[0];
+    descriptors[1].events = POLLIN;
+    while (serverRunning.load()) {
+        if (poll(descriptors, 2, -1) <= 0) continue;
+        if (descriptors[1].revents) break;
+        int client = accept(listener, nullptr, nullptr);
+        if (client >= 0) serveClient(client);
+    }
+    close(listener);
+    close(stopPipe[0]);
+    close(stopPipe[1]);
+}
+
+bool startMetricsServer(const std::string& socketPath) {
+    if (serverRunning.load()) return true;
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) return false;
+    socketPath.copy(address.sun_path, socketPath.size());
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) return false;
+
+    unlink(socketPath.c_str());  // Left over from an earlier run
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listener, 4) < 0 || pipe(stopPipe) < 0) {
+        close(listener);
+        return false;
+    }
+
+    serverRunning.store(true);
+    serverThread = std::thread(metricsServerLoop, listener);
+    return true;
+}
+
+void stopMetricsServer() {
+    if (!serverRunning.exchange(false)) return;
+    ssize_t ignored = write(stopPipe[1], "x", 1);
+    (void)ignored;
+    serverThread.join();
+}
+
+#else
+
+bool startMetricsServer(const std::string& socketPath) {
+    (void)socketPath;
+    return false;  // No UNIX domain sockets on this platform
+}
+
+void stopMetricsServer() {}
+
+#endif
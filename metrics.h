@@ -0,0 +1,77 @@
+/*
+ * Live Pipeline Metrics for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Counters, gauges and latency histograms are plain relaxed atomics, so
+ * updating them from the sensor path never takes a lock. A low-priority
+ * thread serves them in Prometheus text format over a UNIX domain socket:
+ *   curl --unix-socket trainer_metrics.sock http://localhost/metrics
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <cstdint>
+#include <string>
+
+// Metrics Configuration
+const std::string METRICS_SOCKET_PATH = "trainer_metrics.sock";
+
+// Counters (monotonic)
+enum MetricCounter {
+    METRIC_SAMPLES_READ,
+    METRIC_SAMPLES_DROPPED,
+    METRIC_SHOTS_DETECTED,
+    METRIC_HAPTIC_COMMANDS,
+    METRIC_LOOP_OVERRUNS,
+    METRIC_CRITICAL_ALLOCATIONS,  // See alloc_tracker.h
+    METRIC_HAPTIC_COALESCED,      // See haptic_queue.h
+    METRIC_HAPTIC_REJECTED,
+    METRIC_I2C_TRANSACTIONS,      // See i2c_bus.h
+    METRIC_I2C_REJECTED,
+    METRIC_I2C_BUSY_US,
+    METRIC_COUNTER_COUNT
+};
+
+// Gauges (current value)
+enum MetricGauge {
+    GAUGE_LOG_QUEUE_DEPTH,  // Sampled from the trace logger at scrape time
+    GAUGE_SYSTEM_STATE,
+    GAUGE_SAMPLE_RATE,
+    GAUGE_I2C_UTILIZATION,
+    METRIC_GAUGE_COUNT
+};
+
+// Pipeline stages with latency histograms
+enum MetricStage {
+    STAGE_LOOP,
+    STAGE_SENSOR_READ,
+    STAGE_SHOT_ANALYSIS,
+    STAGE_HAPTIC_FEEDBACK,
+    STAGE_HAPTIC_QUEUE,  // Queued to started
+    STAGE_HAPTIC_ACTUATION,  // Duty or effect requested to driver output changing (simulated bus)
+    STAGE_SENSOR_BUS,        // IMU burst read queued to its data in (simulated bus)
+    METRIC_STAGE_COUNT
+};
+
+// Records the lifetime of the object as one stage latency sample
+struct ScopedStageTimer {
+    MetricStage stage;
+    uint64_t startNs;
+
+    explicit ScopedStageTimer(MetricStage s);
+    ~ScopedStageTimer();
+};
+
+// Function Declarations
+void incrementMetric(MetricCounter counter, uint64_t amount = 1);
+void setGauge(MetricGauge gauge, int64_t value);
+void recordStageLatency(MetricStage stage, uint64_t nanoseconds);
+uint64_t metricValue(MetricCounter counter);
+uint64_t stageLatencyCount(MetricStage stage);
+uint64_t stageLatencyQuantileUs(MetricStage stage, double quantile);  // Bucket bound; UINT64_MAX past the last
+void renderPrometheusMetrics(std::string* out);
+bool startMetricsServer(const std::string& socketPath = METRICS_SOCKET_PATH);
+void stopMetricsServer();
+
+#endif // METRICS_H
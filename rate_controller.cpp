@@ -0,0 +1,56 @@
+/*
+ * Adaptive Sample Rate for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "rate_controller.h"
+#include <algorithm>
+
+void initRateController(RateController* controller) {
+    *controller = RateController();
+}
+
+void limitSampleRate(RateController* controller, int maxRate) {
+    controller->maxRate = std::max(1, maxRate);
+    controller->rate = std::min(controller->rate, controller->maxRate);
+}
+
+static void setRate(RateController* controller, int rate) {
+    rate = std::min(rate, controller->maxRate);
+    if (controller->rate != rate) {
+        controller->rate = rate;
+        controller->rateChanges++;
+    }
+}
+
+int updateSampleRate(RateController* controller, const MotionData* sample, bool idle) {
+    // Any motion at all starts capture; only detectShotEnd() quiet counts as still
+    if (!detectShotEnd(sample)) {
+        controller->capturing = true;
+        controller->lastMotionTime = sample->timestamp;
+        setRate(controller, CAPTURE_SAMPLE_RATE);
+        return controller->rate;
+    }
+
+    // startCapture() may stamp a later time than a sample read before a pause
+    if (controller->capturing && (sample->timestamp < controller->lastMotionTime ||
+        sample->timestamp - controller->lastMotionTime < static_cast<unsigned long>(MOTION_TIMEOUT) * 1000)) {
+        return controller->rate;
+    }
+
+    controller->capturing = false;
+    setRate(controller, idle ? IDLE_SAMPLE_RATE : SAMPLE_RATE);
+    return controller->rate;
+}
+
+// The IMU only raises its motion interrupt above threshold, so capture
+// starts without waiting for a sample to confirm it
+void startCapture(RateController* controller, unsigned long timestamp) {
+    controller->capturing = true;
+    controller->lastMotionTime = timestamp;
+    setRate(controller, CAPTURE_SAMPLE_RATE);
+}
+
+uint64_t samplePeriodNs(const RateController* controller) {
+    return 1000000000ULL / controller->rate;
+}
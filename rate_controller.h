@@ -0,0 +1,40 @@
+/*
+ * Adaptive Sample Rate for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Samples slowly while the athlete stands around in STANDBY and switches
+ * to a high capture rate as soon as motion crosses MOTION_THRESHOLD, so
+ * the release is captured finely without paying for it the rest of the
+ * time. The rate drops back once the arm has been still for MOTION_TIMEOUT.
+ * No rate goes above what the IMU buses can read (limitSampleRate).
+ */
+
+#ifndef RATE_CONTROLLER_H
+#define RATE_CONTROLLER_H
+
+#include <cstdint>
+#include "sensors.h"
+
+// Rate Configuration (SAMPLE_RATE is the rate outside STANDBY between shots)
+const int IDLE_SAMPLE_RATE = 25;       // Hz
+const int CAPTURE_SAMPLE_RATE = 1000;  // Hz
+
+struct RateController {
+    int rate;                      // Current sample rate, Hz
+    int maxRate;                   // Bus limit, Hz
+    bool capturing;                // True while at the capture rate
+    unsigned long lastMotionTime;  // Microseconds
+    unsigned long rateChanges;
+
+    RateController() : rate(IDLE_SAMPLE_RATE), maxRate(CAPTURE_SAMPLE_RATE), capturing(false), lastMotionTime(0),
+                       rateChanges(0) {}
+};
+
+// Function Declarations
+void initRateController(RateController* controller);
+void limitSampleRate(RateController* controller, int maxRate);  // Hz, e.g. imuSampleRateLimit()
+int updateSampleRate(RateController* controller, const MotionData* sample, bool idle);
+void startCapture(RateController* controller, unsigned long timestamp);  // Wake-on-motion interrupt, us
+uint64_t samplePeriodNs(const RateController* controller);
+
+#endif // RATE_CONTROLLER_H
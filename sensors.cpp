@@ -0,0 +1,132 @@
+/*
+ * Sensor Processing for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "sensors.h"
+#include "filter_pipeline.h"
+#include "metrics.h"
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+// Utility Functions
+
+double vectorMagnitude(const Vector3D* vec) {
+    return std::sqrt(vec->x * vec->x + vec->y * vec->y + vec->z * vec->z);
+}
+
+double vectorDistance(const Vector3D* vec1, const Vector3D* vec2) {
+    Vector3D diff(vec1->x - vec2->x, vec1->y - vec2->y, vec1->z - vec2->z);
+    return vectorMagnitude(&diff);
+}
+
+void normalizeVector(Vector3D* vec) {
+    double magnitude = vectorMagnitude(vec);
+    if (magnitude > 0) {
+        vec->x /= magnitude;
+        vec->y /= magnitude;
+        vec->z /= magnitude;
+    }
+}
+
+double dotProduct(const Vector3D* vec1, const Vector3D* vec2) {
+    return vec1->x * vec2->x + vec1->y * vec2->y + vec1->z * vec2->z;
+}
+
+Vector3D crossProduct(const Vector3D* vec1, const Vector3D* vec2) {
+    return Vector3D(vec1->y * vec2->z - vec1->z * vec2->y,
+                    vec1->z * vec2->x - vec1->x * vec2->z,
+                    vec1->x * vec2->y - vec1->y * vec2->x);
+}
+
+// Sensor Setup
+
+// The simulated IMUs need no bring-up; each trainer keeps its own motion
+// and calibration state
+void initSensors() {
+    std::cout << "Sensors initialized: " << IMU_COUNT << " IMUs" << std::endl;
+}
+
+// Shot Detection
+
+bool detectShotStart(const MotionData* data) {
+    return data->magnitude * ACCEL_COUNTS_PER_G > SHOT_DETECTION_THRESHOLD;
+}
+
+bool detectShotEnd(const MotionData* data) {
+    return data->magnitude * ACCEL_COUNTS_PER_G < MOTION_THRESHOLD;
+}
+
+// Filtering
+//
+// The single-sample API runs one stage of filter_pipeline.h each, with its
+// own state and sample spacing. Hot paths use a fused Pipeline instead.
+
+void applyLowPassFilter(MotionData* data, double alpha) {
+    static LowPassFilter filter;
+    static SampleClock clock;
+    filter.apply(data, alpha, clock.advance(data->timestamp));
+}
+
+void applyKalmanFilter(MotionData* data) {
+    static Kalman filter;
+    static SampleClock clock;
+    filter.process(data, clock.advance(data->timestamp));
+}
+
+void removeGravity(MotionData* data) {
+    static RemoveGravity filter;
+    static SampleClock clock;
+    filter.process(data, clock.advance(data->timestamp));
+}
+
+// Trajectory Matching
+
+// Similarity in (0, 1]: 1 / (1 + RMS point distance) over the overlapping
+// points. Stored trajectories use the integer version in trajectory_quant.h.
+double calculateTrajectorySimilarity(const std::vector<Vector3D>& traj1,
+                                     const std::vector<Vector3D>& traj2) {
+    size_t n = std::min(traj1.size(), traj2.size());
+    if (n == 0) return 0;
+
+    double sumSquares = 0;
+    for (size_t i = 0; i < n; i++) {
+        double distance = vectorDistance(&traj1[i], &traj2[i]);
+        sumSquares += distance * distance;
+    }
+    return 1.0 / (1.0 + std::sqrt(sumSquares / n));
+}
+
+// Bus Reads
+
+static void onImuRead(I2cBus*, const I2cTransaction* transaction, uint64_t endNs) {
+    incrementMetric(METRIC_SAMPLES_READ);
+    recordStageLatency(STAGE_SENSOR_BUS, endNs - transaction->queuedNs);
+}
+
+// An IMU whose last read has not reached the bus yet gets no second one:
+// that read returns the newest sample when it runs, and this one is lost
+int queueImuReads(I2cBus* buses) {
+    int dropped = 0;
+    for (const ImuBusSlot& slot : IMU_BUS_SLOTS) {
+        if (queueI2cRead(&buses[slot.bus], slot.channel, slot.address, slot.reg, slot.length, slot.span,
+                         onImuRead) != I2C_QUEUED) {
+            dropped++;
+        }
+    }
+    if (dropped > 0) incrementMetric(METRIC_SAMPLES_DROPPED, dropped);
+    return dropped;
+}
+
+// A sample costs each bus its reads, plus a select for a read behind the
+// mux: the haptic drivers may have moved it since
+int imuSampleRateLimit(uint32_t clockHz) {
+    uint64_t busNs[IMU_BUS_COUNT] = {};
+    for (const ImuBusSlot& slot : IMU_BUS_SLOTS) {
+        busNs[slot.bus] += i2cTransactionNs(clockHz, I2C_READ, slot.length);
+        if (slot.channel != I2C_TRUNK) busNs[slot.bus] += i2cTransactionNs(clockHz, I2C_WRITE, 0);
+    }
+    uint64_t slowest = *std::max_element(busNs, busNs + IMU_BUS_COUNT);
+    return static_cast<int>(1000000000ULL / std::max<uint64_t>(slowest, 1));
+}
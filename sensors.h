@@ -8,6 +8,7 @@
 
 #include <vector>
 #include <chrono>
+#include "i2c_bus.h"
 
 // Data Structures
 struct Vector3D {
@@ -21,7 +22,7 @@ struct MotionData {
     Vector3D accel;      // Acceleration in g
     Vector3D gyro;       // Angular velocity in degrees/sec
     double magnitude;    // Acceleration magnitude
-    unsigned long timestamp;
+    unsigned long timestamp;  // Microseconds
     
     MotionData() : magnitude(0), timestamp(0) {}
 };
@@ -34,8 +35,9 @@ struct ShotData {
     Vector3D startPosition;
     Vector3D endPosition;
     std::vector<Vector3D> trajectory; // Store trajectory points
+    bool wasSuccessful;               // Marked made after the shot, see recordShotOutcome()
     
-    ShotData() : timestamp(0), peakAccel(0), duration(0), formScore(0) {
+    ShotData() : timestamp(0), peakAccel(0), duration(0), formScore(0), wasSuccessful(false) {
         trajectory.reserve(100);
     }
 };
@@ -56,22 +58,57 @@ struct CalibrationData {
 
 // Sensor Configuration
 const int MPU6050_ADDRESS = 0x68;
-const int SAMPLE_RATE = 100;  // Hz
+const int SAMPLE_RATE = 100;  // Hz; nominal rate, see rate_controller.h
+const int IMU_COUNT = 4;  // BNO055 + 3x MPU6050
 const int CALIBRATION_SAMPLES = 10;
+const double ACCEL_COUNTS_PER_G = 8192.0;  // MPU6050 raw counts at the +/-4g range
+
+// IMU Bus Placement (see i2c_bus.h). Each SDA/SCL pair is its own
+// controller. The forearm BNO055 and upper-arm MPU6050 carry the shot, so
+// each has a pair to itself. The hand and torso MPU6050s ride the sleeve
+// harness on the DRV pair, sharing its bus with the haptic drivers; the
+// hand one sits behind the mux with them.
+enum ImuBus {
+    IMU_BUS_BNO055,  // BNO055_SDA/BNO055_SCL
+    IMU_BUS_MPU,     // MPU1_SDA/MPU1_SCL
+    IMU_BUS_DRV,     // DRV_SDA/DRV_SCL, shared with the haptic drivers
+    IMU_BUS_COUNT
+};
 
-// Motion Detection Thresholds
+const int BNO055_ADDRESS = 0x28;
+const int MPU6050_ALT_ADDRESS = 0x69;      // AD0 high
+const int BNO055_ACCEL_DATA = 0x08;        // Accel, mag and gyro: 18 bytes
+const int MPU6050_ACCEL_XOUT_H = 0x3B;     // Accel, temperature and gyro: 14 bytes
+const int IMU_HAND_CHANNEL = 3;            // Mux channel past the haptic drivers'
+
+struct ImuBusSlot {
+    int bus;
+    int channel;
+    int address;
+    int reg;
+    int length;
+    const char* span;
+};
+
+const ImuBusSlot IMU_BUS_SLOTS[IMU_COUNT] = {
+    {IMU_BUS_BNO055, I2C_TRUNK, BNO055_ADDRESS, BNO055_ACCEL_DATA, 18, "i2c_read_bno055"},
+    {IMU_BUS_MPU, I2C_TRUNK, MPU6050_ADDRESS, MPU6050_ACCEL_XOUT_H, 14, "i2c_read_mpu6050"},
+    {IMU_BUS_DRV, IMU_HAND_CHANNEL, MPU6050_ADDRESS, MPU6050_ACCEL_XOUT_H, 14, "i2c_read_mpu6050"},
+    {IMU_BUS_DRV, I2C_TRUNK, MPU6050_ALT_ADDRESS, MPU6050_ACCEL_XOUT_H, 14, "i2c_read_mpu6050"},
+};
+
+// Motion Detection Thresholds (raw accelerometer counts, gravity removed:
+// run RemoveGravity from filter_pipeline.h first)
 const int MOTION_THRESHOLD = 5000;
 const int SHOT_DETECTION_THRESHOLD = 15000;
 const int MOTION_TIMEOUT = 1000;  // ms
 
-// Global Variables
-extern CalibrationData calibrationData;
-extern MotionData lastMotionData;
-
 // Function Declarations
 void initSensors();
 bool calibrateSensors();
 void readMotionData(MotionData* data);
+int queueImuReads(I2cBus* buses);  // IMU_BUS_COUNT buses; one burst per IMU, returns the samples dropped
+int imuSampleRateLimit(uint32_t clockHz);  // Highest rate the busiest bus can keep up with
 bool detectShotStart(const MotionData* data);
 bool detectShotEnd(const MotionData* data);
 double calculateFormScore(const MotionData* data, const CalibrationData* cal);
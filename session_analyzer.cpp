@@ -0,0 +1,293 @@
+/*
+ * Offline Session Analyzer for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Re-runs shot detection, form analysis and scoring over a directory of
+ * recorded sessions on a work-stealing thread pool and prints the
+ * aggregated results as CSV. With --generate, first writes that many
+ * synthetic sessions into the directory, recorded as the trainer would.
+ *
+ * Usage: session_analyzer <session-dir> [--threads N] [--output results.csv]
+ *                         [--generate N]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "sensors.h"
+#include "data_logger.h"
+#include "shot_analysis.h"
+#include "hampel_filter.h"
+#include "filter_pipeline.h"
+#include "thread_pool.h"
+#include "shot_generator.h"
+#include "sim_random.h"
+
+const unsigned long MAX_ANALYZER_THREADS = 256;
+const unsigned long MAX_GENERATED_SESSIONS = 1000;
+const int GENERATED_SESSION_SHOTS = 30;
+
+struct SessionResult {
+    std::string filename;
+    bool loaded;
+    size_t samples;
+    PerformanceMetrics metrics;
+
+    SessionResult() : loaded(false), samples(0) {}
+};
+
+bool generateSessions(const std::string& directory, unsigned count);
+void analyzeSession(const std::string& path, SessionResult* result);
+void writeResults(std::ostream& out, const std::vector<SessionResult>& results);
+bool parseCount(const char* text, unsigned long maximum, unsigned* count);
+void printUsage();
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    std::string directory = argv[1];
+    std::string outputFile;
+    unsigned threadCount = 0;
+    unsigned generateCount = 0;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            if (!parseCount(argv[++i], MAX_ANALYZER_THREADS, &threadCount)) {
+                std::cerr << "--threads takes a count from 1 to " << MAX_ANALYZER_THREADS << std::endl;
+                printUsage();
+                return 1;
+            }
+        } else if (arg == "--output" && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (arg == "--generate" && i + 1 < argc) {
+            if (!parseCount(argv[++i], MAX_GENERATED_SESSIONS, &generateCount)) {
+                std::cerr << "--generate takes a count from 1 to " << MAX_GENERATED_SESSIONS << std::endl;
+                printUsage();
+                return 1;
+            }
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (generateCount > 0 && !generateSessions(directory, generateCount)) {
+        return 1;
+    }
+
+    std::vector<std::string> sessions;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (entry.is_regular_file() && entry.path().extension() == SESSION_FILE_EXTENSION) {
+            sessions.push_back(entry.path().string());
+        }
+    }
+    if (error) {
+        std::cerr << "Cannot read " << directory << ": " << error.message() << std::endl;
+        return 1;
+    }
+    std::sort(sessions.begin(), sessions.end());
+
+    // Open the output first so a bad path fails before any analysis runs
+    std::ofstream out;
+    if (!outputFile.empty()) {
+        out.open(outputFile);
+        if (!out) {
+            std::cerr << "Cannot write " << outputFile << std::endl;
+            return 1;
+        }
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Every task writes only its own slot, so results need no locking
+    std::vector<SessionResult> results(sessions.size());
+    WorkStealingPool pool(threadCount);
+    for (size_t i = 0; i < sessions.size(); i++) {
+        pool.submit([&sessions, &results, i] { analyzeSession(sessions[i], &results[i]); });
+    }
+    pool.wait();
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    if (outputFile.empty()) {
+        writeResults(std::cout, results);
+    } else {
+        writeResults(out, results);
+        out.close();
+        if (!out) {
+            std::cerr << "Failed writing " << outputFile << std::endl;
+            return 1;
+        }
+    }
+
+    size_t totalShots = 0;
+    for (const SessionResult& result : results) {
+        totalShots += result.metrics.totalShots;
+    }
+    std::cerr << "Analyzed " << sessions.size() << " sessions (" << totalShots << " shots) in "
+              << elapsed << " s on " << pool.size() << " threads" << std::endl;
+    return 0;
+}
+
+// Each session is one generator's forearm stream at SAMPLE_RATE, with
+// the sensor glitches the trainer's generator adds
+bool generateSessions(const std::string& directory, unsigned count) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        std::cerr << "Cannot create " << directory << ": " << error.message() << std::endl;
+        return false;
+    }
+
+    ShotGeneratorConfig config;
+    config.glitchRate = 0.001;
+    for (unsigned session = 0; session < count; session++) {
+        SimRandom rng;
+        seedSimRandom(&rng, SIM_DEFAULT_SEED, simStream(SIM_STREAM_ATHLETE, session));
+        ShotGenerator generator;
+        initShotGenerator(&generator, config, simNext(&rng));
+        std::vector<MotionData> streams[IMU_COUNT];
+        generateSession(&generator, GENERATED_SESSION_SHOTS, streams, nullptr);
+
+        // Recordings append, so replace any earlier file of the same name
+        char name[32];
+        std::snprintf(name, sizeof(name), "generated_%03u", session);
+        std::filesystem::path path = std::filesystem::path(directory) / (name + SESSION_FILE_EXTENSION);
+        std::filesystem::remove(path, error);
+        if (!saveSessionRecording(path.string(), streams[SHOT_IMU_FOREARM])) {
+            std::cerr << "Cannot write " << path.string() << std::endl;
+            return false;
+        }
+    }
+    std::cerr << "Generated " << count << " sessions of " << GENERATED_SESSION_SHOTS << " shots" << std::endl;
+    return true;
+}
+
+void analyzeSession(const std::string& path, SessionResult* result) {
+    result->filename = std::filesystem::path(path).filename().string();
+
+    std::vector<MotionData> samples;
+    if (!loadSessionRecording(path, &samples)) return;
+    result->loaded = true;
+    result->samples = samples.size();
+    if (samples.size() < 2) return;
+
+    // Remove single-sample sensor glitches before they can start a shot,
+    // then filter as the device does: the shot thresholds are for
+    // acceleration with gravity removed
+    hampelFilterBatch(&samples);
+    MotionFilterPipeline filters;
+    filters.processBlock(samples.data(), samples.size());
+    
+    std::vector<ShotSegment> segments;
+    detectShots(samples, &segments);
+
+    std::vector<FreeThrowData> shots;
+    shots.reserve(segments.size());
+    for (const ShotSegment& segment : segments) {
+        shots.push_back(analyzeShotForm(&samples[segment.start], segment.end - segment.start));
+    }
+
+    // As on the device, the first shots of a session form the reference
+    FreeThrowCalibration calibration;
+    calibrateFromShots(shots.data(), std::min(shots.size(), static_cast<size_t>(CALIBRATION_SAMPLES)),
+                       &calibration);
+
+    PerformanceMetrics& metrics = result->metrics;
+    metrics.totalShots = static_cast<int>(shots.size());
+    metrics.totalTrainingTime = (samples.back().timestamp - samples.front().timestamp) / 1000;
+    if (shots.empty()) return;
+
+    std::vector<double> scores;
+    scores.reserve(shots.size());
+    for (const FreeThrowData& shot : shots) {
+        scores.push_back(scoreShotForm(shot, calibration));
+    }
+
+    double sum = 0, sumSquares = 0;
+    for (double score : scores) {
+        sum += score;
+        sumSquares += score * score;
+        metrics.bestScore = std::max(metrics.bestScore, score);
+    }
+    metrics.averageScore = sum / scores.size();
+    double variance = sumSquares / scores.size() - metrics.averageScore * metrics.averageScore;
+    metrics.consistencyScore = std::max(0.0, 100.0 - std::sqrt(std::max(variance, 0.0)));
+
+    // Trend: second half of the session against the first
+    size_t half = scores.size() / 2;
+    if (half > 0) {
+        double firstHalf = 0, secondHalf = 0;
+        for (size_t i = 0; i < half; i++) firstHalf += scores[i];
+        for (size_t i = half; i < scores.size(); i++) secondHalf += scores[i];
+        double change = secondHalf / (scores.size() - half) - firstHalf / half;
+        metrics.improvementTrend = (change > 0) - (change < 0);
+    }
+}
+
+void writeResults(std::ostream& out, const std::vector<SessionResult>& results) {
+    out << "session,samples,shots,average_score,best_score,consistency,trend,training_ms" << std::endl;
+
+    PerformanceMetrics total;
+    size_t totalSamples = 0;
+    double weightedScore = 0, weightedConsistency = 0;
+    for (const SessionResult& result : results) {
+        if (!result.loaded) {
+            std::cerr << "Skipped unreadable session " << result.filename << std::endl;
+            continue;
+        }
+        const PerformanceMetrics& metrics = result.metrics;
+        out << result.filename << "," << result.samples << "," << metrics.totalShots << ","
+            << metrics.averageScore << "," << metrics.bestScore << "," << metrics.consistencyScore << ","
+            << metrics.improvementTrend << "," << metrics.totalTrainingTime << "\n";
+
+        totalSamples += result.samples;
+        total.totalShots += metrics.totalShots;
+        total.totalTrainingTime += metrics.totalTrainingTime;
+        total.bestScore = std::max(total.bestScore, metrics.bestScore);
+        total.improvementTrend += metrics.improvementTrend;
+        weightedScore += metrics.averageScore * metrics.totalShots;
+        weightedConsistency += metrics.consistencyScore * metrics.totalShots;
+    }
+
+    if (total.totalShots > 0) {
+        total.averageScore = weightedScore / total.totalShots;
+        total.consistencyScore = weightedConsistency / total.totalShots;
+    }
+    out << "TOTAL," << totalSamples << "," << total.totalShots << "," << total.averageScore << ","
+        << total.bestScore << "," << total.consistencyScore << "," << total.improvementTrend << ","
+        << total.totalTrainingTime << std::endl;
+}
+
+// Whole decimal numbers only; no sign, suffix or out-of-range count
+bool parseCount(const char* text, unsigned long maximum, unsigned* count) {
+    std::string value = text;
+    if (value.empty() || !std::all_of(value.begin(), value.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+    unsigned long parsed;
+    try {
+        parsed = std::stoul(value);
+    } catch (const std::out_of_range&) {
+        return false;
+    }
+    if (parsed == 0 || parsed > maximum) return false;
+    *count = static_cast<unsigned>(parsed);
+    return true;
+}
+
+void printUsage() {
+    std::cerr << "Usage: session_analyzer <session-dir> [--threads N] [--output results.csv] [--generate N]"
+              << std::endl;
+}
@@ -0,0 +1,231 @@
+/*
+ * Shot Analysis for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "shot_analysis.h"
+#include "spectral_features.h"
+#include <cmath>
+#include <algorithm>
+
+const size_t NO_SAMPLE = static_cast<size_t>(-1);
+
+// Score penalty weights, applied per tolerance of error (capped at 2x)
+const double ELBOW_PENALTY = 20.0;
+const double WRIST_PENALTY = 15.0;
+const double TIMING_PENALTY = 15.0;
+const double DURATION_PENALTY = 10.0;
+
+const double SET_POINT_RATE = 20.0;  // deg/s of elbow extension that ends the set point
+
+static double secondsBetween(const MotionData& from, const MotionData& to) {
+    return (to.timestamp - from.timestamp) / 1000000.0;
+}
+
+// Integrates one gyro axis (deg/s) over [begin, end) using sample spacing
+static double integrateGyro(const MotionData* samples, size_t begin, size_t end,
+                            double Vector3D::*axis) {
+    double angle = 0;
+    for (size_t i = begin + 1; i < end; i++) {
+        angle += samples[i].gyro.*axis * secondsBetween(samples[i - 1], samples[i]);
+    }
+    return angle;
+}
+
+size_t detectShots(const std::vector<MotionData>& samples, std::vector<ShotSegment>* shots) {
+    shots->clear();
+
+    size_t lastEnd = 0;
+    size_t i = 0;
+    while (i < samples.size()) {
+        if (!detectShotStart(&samples[i])) {
+            i++;
+            continue;
+        }
+
+        // Back up to where the motion began so the dip is included
+        size_t start = i;
+        while (start > lastEnd && !detectShotEnd(&samples[start - 1])) {
+            start--;
+        }
+
+        // The shot ends once the arm has been still for SHOT_SETTLE_TIME
+        size_t quiet = NO_SAMPLE;
+        size_t j = i + 1;
+        for (; j < samples.size(); j++) {
+            if (!detectShotEnd(&samples[j])) {
+                quiet = NO_SAMPLE;
+                continue;
+            }
+            if (quiet == NO_SAMPLE) quiet = j;
+            if (samples[j].timestamp - samples[quiet].timestamp >= SHOT_SETTLE_TIME * 1000) break;
+        }
+
+        size_t end = quiet != NO_SAMPLE ? quiet : samples.size();
+        shots->push_back(ShotSegment(start, end));
+        lastEnd = end;
+        i = j;
+    }
+    return shots->size();
+}
+
+// Jerk RMS and log dimensionless jerk (acceleration form, for IMUs)
+static void analyzeJerk(const MotionData* samples, size_t count, double peakAccel, FreeThrowData* shotData) {
+    double jerkSquares = 0;
+    for (size_t i = 1; i < count; i++) {
+        double dt = secondsBetween(samples[i - 1], samples[i]);
+        if (dt <= 0) continue;
+        Vector3D change(samples[i].accel.x - samples[i - 1].accel.x,
+                        samples[i].accel.y - samples[i - 1].accel.y,
+                        samples[i].accel.z - samples[i - 1].accel.z);
+        double jerk = vectorMagnitude(&change) / dt;
+        jerkSquares += jerk * jerk * dt;
+    }
+
+    double duration = secondsBetween(samples[0], samples[count - 1]);
+    if (duration <= 0 || jerkSquares <= 0 || peakAccel <= 0) return;
+    shotData->jerkRms = std::sqrt(jerkSquares / duration);
+    shotData->smoothness = -std::log(duration * jerkSquares / (peakAccel * peakAccel));
+}
+
+// Set point: where elbow extension starts, walking back from its peak rate
+static size_t findSetPoint(const MotionData* samples, size_t release) {
+    size_t peak = 0;
+    for (size_t i = 1; i <= release; i++) {
+        if (std::abs(samples[i].gyro.y) > std::abs(samples[peak].gyro.y)) peak = i;
+    }
+    size_t setPoint = peak;
+    while (setPoint > 0 && std::abs(samples[setPoint].gyro.y) > SET_POINT_RATE) {
+        setPoint--;
+    }
+    return setPoint;
+}
+
+// Tremor-band gyro power over the window ending at the set point. The
+// extension itself would swamp the band, so the window stops before it.
+static double tremorAtSetPoint(const MotionData* samples, size_t count, size_t setPoint) {
+    double duration = secondsBetween(samples[0], samples[count - 1]);
+    if (duration <= 0) return 0;
+
+    int window = static_cast<int>(std::min<size_t>(SDFT_WINDOW, setPoint + 1));
+    SlidingDft dft;
+    if (!initSlidingDft(&dft, (count - 1) / duration, TREMOR_BAND_LOW, TREMOR_BAND_HIGH, window)) return 0;
+    for (size_t i = setPoint + 1 - window; i <= setPoint; i++) {
+        slidingDftUpdate(&dft, samples[i].gyro);
+    }
+    return slidingDftBandPower(&dft);
+}
+
+FreeThrowData analyzeShotForm(const MotionData* samples, size_t count, const double* tremorPower) {
+    FreeThrowData shotData = FreeThrowData();
+    if (count < 2) return shotData;
+
+    // Release is taken as the acceleration peak
+    size_t release = 0;
+    for (size_t i = 1; i < count; i++) {
+        if (samples[i].magnitude > samples[release].magnitude) release = i;
+    }
+
+    double lateralSquares = 0;
+    for (size_t i = 0; i < count; i++) {
+        lateralSquares += samples[i].accel.x * samples[i].accel.x;
+    }
+
+    // Elbow: set-point angle, 180 minus the extension swept up to release.
+    // Wrist: flexion swept during the follow-through.
+    shotData.elbowAngle = 180.0 - std::abs(integrateGyro(samples, 0, release + 1, &Vector3D::y));
+    shotData.wristAngle = std::abs(integrateGyro(samples, release, count, &Vector3D::x));
+    shotData.releaseTiming = secondsBetween(samples[0], samples[release]);
+    shotData.followThrough = secondsBetween(samples[release], samples[count - 1]);
+    shotData.bodyBalance = std::sqrt(lateralSquares / count);
+    shotData.wasSuccessful = false;  // Outcome is recorded separately
+    shotData.shotDuration = (samples[count - 1].timestamp - samples[0].timestamp) / 1000;
+    shotData.peakAcceleration = samples[release].magnitude * GRAVITY;
+    size_t setPoint = findSetPoint(samples, release);
+    shotData.tremorPower = tremorPower ? tremorPower[setPoint] : tremorAtSetPoint(samples, count, setPoint);
+    analyzeJerk(samples, count, samples[release].magnitude, &shotData);
+    return shotData;
+}
+
+void calibrateFromShots(const FreeThrowData* shots, size_t count, FreeThrowCalibration* calibration) {
+    *calibration = FreeThrowCalibration();
+    if (count == 0) return;
+
+    for (size_t i = 0; i < count; i++) {
+        calibration->avgElbowAngle += shots[i].elbowAngle;
+        calibration->avgWristAngle += shots[i].wristAngle;
+        calibration->avgReleaseTiming += shots[i].releaseTiming;
+        calibration->avgFollowThrough += shots[i].followThrough;
+        calibration->avgBodyBalance += shots[i].bodyBalance;
+    }
+    calibration->avgElbowAngle /= count;
+    calibration->avgWristAngle /= count;
+    calibration->avgReleaseTiming /= count;
+    calibration->avgFollowThrough /= count;
+    calibration->avgBodyBalance /= count;
+
+    for (size_t i = 0; i < count; i++) {
+        calibration->stdDevElbow += std::pow(shots[i].elbowAngle - calibration->avgElbowAngle, 2);
+        calibration->stdDevWrist += std::pow(shots[i].wristAngle - calibration->avgWristAngle, 2);
+        calibration->stdDevTiming += std::pow(shots[i].releaseTiming - calibration->avgReleaseTiming, 2);
+    }
+    calibration->stdDevElbow = std::sqrt(calibration->stdDevElbow / count);
+    calibration->stdDevWrist = std::sqrt(calibration->stdDevWrist / count);
+    calibration->stdDevTiming = std::sqrt(calibration->stdDevTiming / count);
+    calibration->isValid = true;
+}
+
+double scoreShotForm(const FreeThrowData& shot, const FreeThrowCalibration& calibration) {
+    double elbowError = std::abs(shot.elbowAngle - calibration.avgElbowAngle) / ELBOW_ANGLE_TOLERANCE;
+    double wristError = std::abs(shot.wristAngle - calibration.avgWristAngle) / WRIST_ANGLE_TOLERANCE;
+    double timingError = std::abs(shot.releaseTiming - calibration.avgReleaseTiming) / RELEASE_TIMING_TOLERANCE;
+
+    double score = 100.0;
+    score -= ELBOW_PENALTY * std::min(elbowError, 2.0);
+    score -= WRIST_PENALTY * std::min(wristError, 2.0);
+    score -= TIMING_PENALTY * std::min(timingError, 2.0);
+
+    double duration = shot.shotDuration / 1000.0;
+    if (duration < SHOT_DURATION_MIN || duration > SHOT_DURATION_MAX) {
+        score -= DURATION_PENALTY;
+    }
+    return std::max(score, 0.0);
+}
+
+// Forearm path by dead reckoning: the gravity-free acceleration integrated
+// twice from rest, kept at SHOT_TRAJECTORY_POINTS evenly spaced samples.
+// It drifts, but shots are compared with each other, not with the court.
+static void estimateTrajectory(const MotionData* samples, size_t count, std::vector<Vector3D>* trajectory) {
+    trajectory->clear();
+    if (count == 0) return;
+
+    size_t points = std::min(count, static_cast<size_t>(SHOT_TRAJECTORY_POINTS));
+    Vector3D velocity, position;
+    size_t next = 0;
+    for (size_t i = 0; i < count && trajectory->size() < points; i++) {
+        if (i > 0) {
+            double dt = secondsBetween(samples[i - 1], samples[i]);
+            velocity.x += samples[i].accel.x * GRAVITY * dt;
+            velocity.y += samples[i].accel.y * GRAVITY * dt;
+            velocity.z += samples[i].accel.z * GRAVITY * dt;
+            position.x += velocity.x * dt;
+            position.y += velocity.y * dt;
+            position.z += velocity.z * dt;
+        }
+        if (i == next) {
+            trajectory->push_back(position);
+            next = points > 1 ? (trajectory->size() * (count - 1)) / (points - 1) : count;
+        }
+    }
+}
+
+void buildShotRecord(const MotionData* samples, size_t count, const FreeThrowData& shot, double formScore,
+                     ShotData* record) {
+    record->peakAccel = shot.peakAcceleration;
+    record->duration = shot.shotDuration;
+    record->formScore = formScore;
+    record->wasSuccessful = shot.wasSuccessful;
+    estimateTrajectory(samples, count, &record->trajectory);
+    record->startPosition = record->trajectory.empty() ? Vector3D() : record->trajectory.front();
+    record->endPosition = record->trajectory.empty() ? Vector3D() : record->trajectory.back();
+}
@@ -0,0 +1,73 @@
+/*
+ * Shot Analysis for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Detection, form analysis and scoring shared by the interactive trainer
+ * and the offline session analyzer.
+ */
+
+#ifndef SHOT_ANALYSIS_H
+#define SHOT_ANALYSIS_H
+
+#include <vector>
+#include <cstddef>
+#include "sensors.h"
+
+// Basketball-specific data structures
+struct FreeThrowData {
+    double elbowAngle;
+    double wristAngle;
+    double releaseTiming;
+    double followThrough;
+    double bodyBalance;
+    bool wasSuccessful;
+    unsigned long shotDuration;
+    double peakAcceleration;
+    double tremorPower;   // Gyro power in the tremor band at the set point, (deg/s)^2
+    double jerkRms;       // g/s
+    double smoothness;    // Log dimensionless jerk; closer to zero is smoother
+};
+
+// Per-athlete reference form learned in calibration mode
+struct FreeThrowCalibration {
+    double avgElbowAngle;
+    double avgWristAngle;
+    double avgReleaseTiming;
+    double avgFollowThrough;
+    double avgBodyBalance;
+    double stdDevElbow;
+    double stdDevWrist;
+    double stdDevTiming;
+    bool isValid;
+};
+
+// A detected shot: sample index range [start, end)
+struct ShotSegment {
+    size_t start;
+    size_t end;
+
+    ShotSegment() : start(0), end(0) {}
+    ShotSegment(size_t s, size_t e) : start(s), end(e) {}
+};
+
+// Basketball-specific thresholds
+const double GRAVITY = 9.80665;  // m/s^2 per g
+const double ELBOW_ANGLE_TOLERANCE = 5.0;  // degrees
+const double WRIST_ANGLE_TOLERANCE = 3.0;  // degrees
+const double RELEASE_TIMING_TOLERANCE = 0.1;  // seconds
+const double SHOT_DURATION_MIN = 1.2;  // seconds
+const double SHOT_DURATION_MAX = 1.8;  // seconds
+const unsigned long SHOT_SETTLE_TIME = 100;  // ms below MOTION_THRESHOLD that ends a shot
+const int SHOT_TRAJECTORY_POINTS = 50;  // Recorded per shot, so stored trajectories align point for point
+
+// Function Declarations
+size_t detectShots(const std::vector<MotionData>& samples, std::vector<ShotSegment>* shots);
+// tremorPower, if given, is the tremor band power after each sample from
+// a SlidingDft running on the stream; otherwise a DFT is run here
+FreeThrowData analyzeShotForm(const MotionData* samples, size_t count, const double* tremorPower = nullptr);
+void calibrateFromShots(const FreeThrowData* shots, size_t count, FreeThrowCalibration* calibration);
+double scoreShotForm(const FreeThrowData& shot, const FreeThrowCalibration& calibration);
+void buildShotRecord(const MotionData* samples, size_t count, const FreeThrowData& shot, double formScore,
+                     ShotData* record);  // No allocation once record->trajectory is reserved
+
+#endif // SHOT_ANALYSIS_H
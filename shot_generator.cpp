@@ -0,0 +1,224 @@
+/*
+ * Synthetic Shot Generator for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "shot_generator.h"
+#include <algorithm>
+#include <cmath>
+
+const double PI = 3.14159265358979323846;
+const double HALF_PI = PI / 2.0;
+
+// Nominal phase durations in seconds at tempo 1.0
+const double DIP_TIME = 0.35;
+const double SET_TIME = 0.30;
+const double RELEASE_TIME = 0.25;
+const double FOLLOW_TIME = 0.40;
+const double FATIGUE_SLOWDOWN = 0.3;  // Pace lost when fully fatigued
+
+// Forward acceleration while raising the ball: between MOTION_THRESHOLD
+// and SHOT_DETECTION_THRESHOLD, so detection starts the shot at the set
+const double SET_ACCEL = 0.8;  // g
+const double DIP_ACCEL = 0.3;  // g
+const double SHOULDER_RAISE_RATE = 60.0;  // deg/s peak
+const double SWAY_FREQUENCY = 1.5;  // Hz
+const double GLITCH_ACCEL = 4.0;    // g, typical MPU6050 single-sample spike
+const double TREMOR_FREQUENCY = 10.0;  // Hz, physiological tremor
+
+// Ideal motion of the shooting arm at one instant, before sensor effects
+struct ArmMotion {
+    double forward;    // Forearm acceleration along the shot, g
+    double vertical;   // Body acceleration from the leg dip, g
+    double lateral;    // Side-to-side sway, g
+    double extension;  // Elbow extension rate, deg/s
+    double flexion;    // Wrist flexion rate, deg/s
+    double raise;      // Shoulder raise rate, deg/s
+
+    ArmMotion() : forward(0), vertical(0), lateral(0), extension(0), flexion(0), raise(0) {}
+};
+
+// How strongly each IMU sees each component, indexed by ShotImu
+struct ImuCoupling {
+    double forward, vertical, lateral, extension, flexion, raise;
+};
+
+static const ImuCoupling IMU_COUPLING[IMU_COUNT] = {
+    {1.0, 0.3, 1.0, 1.0, 1.0, 1.0},  // Forearm
+    {0.5, 0.5, 0.8, 0.6, 0.0, 1.0},  // Upper arm
+    {1.4, 0.3, 1.2, 1.0, 1.5, 1.0},  // Hand
+    {0.1, 1.0, 1.0, 0.0, 0.0, 0.1},  // Torso
+};
+
+// Per-shot targets drawn from the config, fatigue and form variation
+struct ShotPlan {
+    double dipTime, setTime, releaseTime, followTime;
+    double elbowAngle, wristFlexion, peakAccel, sway, tremor;
+};
+
+void initShotGenerator(ShotGenerator* generator, const ShotGeneratorConfig& config, uint64_t seed) {
+    *generator = ShotGenerator();
+    generator->config = config;
+    generator->config.sampleRate = std::min(std::max(config.sampleRate, 1.0), SHOT_GENERATOR_MAX_RATE);
+    generator->config.tempo = std::max(config.tempo, 0.1);
+    seedSimRandom(&generator->rng, seed);
+}
+
+static void emitSample(ShotGenerator* generator, const ArmMotion& motion, std::vector<MotionData> streams[IMU_COUNT]) {
+    const ShotGeneratorConfig& config = generator->config;
+    SimRandom* rng = &generator->rng;
+    double dt = 1.0 / config.sampleRate;
+    double driftStep = config.gyroDrift * std::sqrt(dt);
+    double gyroNoise = config.noiseStdDev * 100.0;
+    unsigned long timestamp = static_cast<unsigned long>(generator->time * 1000000.0 + 0.5);
+
+    for (int imu = 0; imu < IMU_COUNT; imu++) {
+        const ImuCoupling& coupling = IMU_COUPLING[imu];
+        Vector3D& bias = generator->gyroBias[imu];
+        bias.x += simGaussian(rng, 0, driftStep);
+        bias.y += simGaussian(rng, 0, driftStep);
+        bias.z += simGaussian(rng, 0, driftStep);
+
+        MotionData sample;
+        sample.timestamp = timestamp;
+        sample.accel.x = motion.lateral * coupling.lateral + simGaussian(rng, 0, config.noiseStdDev);
+        sample.accel.y = motion.forward * coupling.forward + simGaussian(rng, 0, config.noiseStdDev);
+        double dynamicZ = motion.vertical * coupling.vertical + simGaussian(rng, 0, config.noiseStdDev);
+        sample.accel.z = 1.0 + dynamicZ;
+        sample.gyro.x = motion.flexion * coupling.flexion + bias.x + simGaussian(rng, 0, gyroNoise);
+        sample.gyro.y = motion.extension * coupling.extension + bias.y + simGaussian(rng, 0, gyroNoise);
+        sample.gyro.z = motion.raise * coupling.raise + bias.z + simGaussian(rng, 0, gyroNoise);
+        if (config.glitchRate > 0 && simUniform(rng) < config.glitchRate) {
+            sample.accel.y += GLITCH_ACCEL;
+        }
+        sample.magnitude = std::sqrt(sample.accel.x * sample.accel.x + sample.accel.y * sample.accel.y +
+                                     dynamicZ * dynamicZ);
+        streams[imu].push_back(sample);
+    }
+    generator->time += dt;
+}
+
+static ShotPlan planShot(ShotGenerator* generator) {
+    const ShotGeneratorConfig& config = generator->config;
+    SimRandom* rng = &generator->rng;
+    double fatigue = generator->fatigue;
+
+    // Tired shooters slow down, drop the elbow, snap the wrist less, sway
+    // more and shake more
+    double pace = config.tempo * (1.0 - FATIGUE_SLOWDOWN * fatigue);
+    ShotPlan plan;
+    plan.dipTime = DIP_TIME / pace;
+    plan.setTime = SET_TIME / pace;
+    plan.releaseTime = RELEASE_TIME / pace;
+    plan.followTime = FOLLOW_TIME / pace;
+    plan.elbowAngle = config.elbowAngle - 8.0 * fatigue + simGaussian(rng, 0, config.formVariation);
+    plan.elbowAngle = std::min(std::max(plan.elbowAngle, 30.0), 175.0);
+    plan.wristFlexion = config.wristFlexion * (1.0 - 0.2 * fatigue) +
+                        simGaussian(rng, 0, config.formVariation * 0.5);
+    plan.wristFlexion = std::max(plan.wristFlexion, 0.0);
+    plan.peakAccel = config.peakAccel * (1.0 - 0.2 * fatigue) * (1.0 + simGaussian(rng, 0, 0.05));
+    plan.peakAccel = std::max(plan.peakAccel, 1.2 * SHOT_DETECTION_THRESHOLD / ACCEL_COUNTS_PER_G);
+    plan.sway = 0.02 + 0.08 * fatigue;
+    plan.tremor = config.tremorAmplitude * (1.0 + 2.0 * fatigue);
+    return plan;
+}
+
+// Emits samples for one phase; shape(phase, motion) fills in the motion
+template <typename Shape>
+static void emitPhase(ShotGenerator* generator, double duration, double sway, double tremor,
+                      std::vector<MotionData> streams[IMU_COUNT], Shape shape) {
+    double end = generator->time + duration;
+    double start = generator->time;
+    while (generator->time < end) {
+        ArmMotion motion;
+        motion.lateral = sway * std::sin(2.0 * PI * SWAY_FREQUENCY * generator->time);
+        shape((generator->time - start) / duration, &motion);
+        double shake = tremor * std::sin(2.0 * PI * TREMOR_FREQUENCY * generator->time);
+        motion.extension += shake;
+        motion.flexion += shake;
+        emitSample(generator, motion, streams);
+    }
+}
+
+void generateShot(ShotGenerator* generator, std::vector<MotionData> streams[IMU_COUNT],
+                  FreeThrowData* truth) {
+    ShotPlan plan = planShot(generator);
+    double extension = 180.0 - plan.elbowAngle;
+    double extensionRate = extension * PI / (2.0 * plan.releaseTime);
+    double flexionRate = plan.wristFlexion * PI / plan.followTime;
+    double peak = plan.peakAccel;
+
+    emitPhase(generator, generator->config.restTime, plan.sway * 0.5, plan.tremor, streams, [](double, ArmMotion*) {});
+
+    emitPhase(generator, plan.dipTime, plan.sway, plan.tremor, streams, [](double phase, ArmMotion* motion) {
+        double bend = std::sin(2.0 * PI * phase);
+        motion->forward = DIP_ACCEL * bend;
+        motion->vertical = -DIP_ACCEL * bend;
+    });
+
+    emitPhase(generator, plan.setTime, plan.sway, plan.tremor, streams, [](double phase, ArmMotion* motion) {
+        motion->forward = SET_ACCEL;
+        motion->raise = SHOULDER_RAISE_RATE * std::sin(PI * phase);
+    });
+
+    // Elbow extends as the forearm accelerates; the peak lands at release
+    emitPhase(generator, plan.releaseTime, plan.sway, plan.tremor, streams,
+              [peak, extensionRate](double phase, ArmMotion* motion) {
+        double ramp = std::sin(HALF_PI * phase);
+        motion->forward = SET_ACCEL + (peak - SET_ACCEL) * ramp * ramp;
+        motion->extension = extensionRate * std::sin(PI * phase);
+    });
+
+    // Wrist snaps in the first half, while the arm is still above MOTION_THRESHOLD
+    emitPhase(generator, plan.followTime, plan.sway, plan.tremor, streams,
+              [peak, flexionRate](double phase, ArmMotion* motion) {
+        double decay = std::cos(HALF_PI * phase);
+        motion->forward = peak * decay * decay;
+        if (phase < 0.5) motion->flexion = flexionRate * std::sin(2.0 * PI * phase);
+    });
+
+    // Ground truth as analyzeShotForm() measures it: from the set to the
+    // point where the arm drops below MOTION_THRESHOLD
+    double settle = MOTION_THRESHOLD / ACCEL_COUNTS_PER_G;
+    double followThrough = plan.followTime * std::acos(std::sqrt(settle / peak)) / HALF_PI;
+    if (truth) {
+        *truth = FreeThrowData();
+        truth->elbowAngle = plan.elbowAngle;
+        truth->wristAngle = plan.wristFlexion;
+        truth->releaseTiming = plan.setTime + plan.releaseTime;
+        truth->followThrough = followThrough;
+        truth->bodyBalance = plan.sway / std::sqrt(2.0);
+        truth->wasSuccessful = false;
+        truth->shotDuration = static_cast<unsigned long>((truth->releaseTiming + followThrough) * 1000.0);
+        truth->peakAcceleration = peak * GRAVITY;
+        truth->tremorPower = plan.tremor * plan.tremor;  // Forearm extension and flexion axes
+    }
+
+    generator->shotsGenerated++;
+    generator->fatigue = std::min(generator->fatigue + generator->config.fatigueRate, 1.0);
+}
+
+size_t maxShotSamples(const ShotGenerator* generator) {
+    const ShotGeneratorConfig& config = generator->config;
+    double slowestPace = config.tempo * (1.0 - FATIGUE_SLOWDOWN);
+    double seconds = config.restTime + (DIP_TIME + SET_TIME + RELEASE_TIME + FOLLOW_TIME) / slowestPace;
+    return static_cast<size_t>(std::ceil(seconds * config.sampleRate)) + 5;  // One extra per phase
+}
+
+size_t generateSession(ShotGenerator* generator, int shots, std::vector<MotionData> streams[IMU_COUNT],
+                       std::vector<FreeThrowData>* truths) {
+    // Rest + four phases per shot; reserve once so long runs never regrow
+    double slowestPace = generator->config.tempo * (1.0 - FATIGUE_SLOWDOWN);
+    double shotTime = generator->config.restTime + (DIP_TIME + SET_TIME + RELEASE_TIME + FOLLOW_TIME) / slowestPace;
+    size_t expected = static_cast<size_t>(shots * shotTime * generator->config.sampleRate) + 1;
+    for (int imu = 0; imu < IMU_COUNT; imu++) {
+        streams[imu].reserve(streams[imu].size() + expected);
+    }
+
+    FreeThrowData truth;
+    for (int i = 0; i < shots; i++) {
+        generateShot(generator, streams, &truth);
+        if (truths) truths->push_back(truth);
+    }
+    return streams[SHOT_IMU_FOREARM].size();
+}
@@ -0,0 +1,72 @@
+/*
+ * Synthetic Shot Generator for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Synthesizes multi-IMU MotionData for a free throw (dip, set, release,
+ * follow-through) with sensor noise, gyro drift, tempo and fatigue, so
+ * detection, filtering and scoring can run at production data rates
+ * without hardware. accel includes 1g of gravity on z; magnitude is the
+ * gravity-free acceleration that shot detection thresholds.
+ */
+
+#ifndef SHOT_GENERATOR_H
+#define SHOT_GENERATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "sensors.h"
+#include "shot_analysis.h"
+#include "sim_random.h"
+
+// Sensor placement, one stream per IMU (IMU_COUNT)
+enum ShotImu {
+    SHOT_IMU_FOREARM,    // BNO055; the stream shot analysis reads
+    SHOT_IMU_UPPER_ARM,
+    SHOT_IMU_HAND,
+    SHOT_IMU_TORSO
+};
+
+// Generator Configuration
+const double SHOT_GENERATOR_MAX_RATE = 10000.0;  // Hz
+
+struct ShotGeneratorConfig {
+    double sampleRate;       // Hz, up to SHOT_GENERATOR_MAX_RATE
+    double tempo;            // Phase speed; 1.0 is nominal, 2.0 twice as fast
+    double restTime;         // Seconds of stillness before each shot
+    double elbowAngle;       // Set-point elbow angle, degrees
+    double wristFlexion;     // Follow-through wrist flexion, degrees
+    double peakAccel;        // Release acceleration, g
+    double formVariation;    // Shot-to-shot standard deviation, degrees
+    double noiseStdDev;      // White noise; g for accel, 100x for gyro deg/s
+    double gyroDrift;        // Gyro bias random walk, deg/s per sqrt(second)
+    double fatigueRate;      // Fatigue added per shot (0 = none, 1 = exhausted)
+    double glitchRate;       // Chance per IMU sample of a one-sample accel spike
+    double tremorAmplitude;  // 10 Hz gyro tremor, deg/s; grows with fatigue
+
+    ShotGeneratorConfig() : sampleRate(SAMPLE_RATE), tempo(1.0), restTime(1.0),
+                           elbowAngle(90.0), wristFlexion(45.0), peakAccel(2.5),
+                           formVariation(2.0), noiseStdDev(0.01), gyroDrift(0.05),
+                           fatigueRate(0.02), glitchRate(0.0),
+                           tremorAmplitude(1.5) {}
+};
+
+struct ShotGenerator {
+    ShotGeneratorConfig config;
+    SimRandom rng;
+    double time;             // Seconds since the generator started
+    double fatigue;          // 0..1, slows tempo and drops the elbow
+    Vector3D gyroBias[IMU_COUNT];
+    int shotsGenerated;
+
+    ShotGenerator() : time(0), fatigue(0), shotsGenerated(0) {}
+};
+
+// Function Declarations
+void initShotGenerator(ShotGenerator* generator, const ShotGeneratorConfig& config, uint64_t seed);
+void generateShot(ShotGenerator* generator, std::vector<MotionData> streams[IMU_COUNT],
+                  FreeThrowData* truth);
+size_t maxShotSamples(const ShotGenerator* generator);  // Per stream, at full fatigue
+size_t generateSession(ShotGenerator* generator, int shots, std::vector<MotionData> streams[IMU_COUNT],
+                       std::vector<FreeThrowData>* truths);
+
+#endif // SHOT_GENERATOR_H
@@ -0,0 +1,144 @@
+/*
+ * Simulation Random Numbers for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "sim_random.h"
+#include <atomic>
+#include <cmath>
+
+static std::atomic<uint64_t> simulationSeed(SIM_DEFAULT_SEED);
+static std::atomic<uint64_t> nextStream(0);
+
+static inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static uint64_t splitMix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void seedSimRandom(SimRandom* rng, uint64_t seed, uint64_t stream) {
+    // SplitMix64 expansion never yields the all-zero state
+    uint64_t mix = seed;
+    for (int i = 0; i < 4; i++) {
+        rng->state[i] = splitMix64(&mix);
+    }
+    for (uint64_t i = 0; i < (stream >> SIM_STREAM_INDEX_BITS); i++) {
+        simLongJump(rng);
+    }
+    for (uint64_t i = 0; i < (stream & ((1ULL << SIM_STREAM_INDEX_BITS) - 1)); i++) {
+        simJump(rng);
+    }
+    rng->hasSpareGaussian = false;
+}
+
+uint64_t simNext(SimRandom* rng) {
+    uint64_t* s = rng->state;
+    uint64_t result = rotateLeft(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotateLeft(s[3], 45);
+
+    return result;
+}
+
+uint32_t simUniformInt(SimRandom* rng, uint32_t bound) {
+    // Multiply-shift range reduction; bias is below 2^-32
+    return static_cast<uint32_t>(((simNext(rng) >> 32) * bound) >> 32);
+}
+
+double simUniform(SimRandom* rng) {
+    return (simNext(rng) >> 11) * (1.0 / 9007199254740992.0);  // 53-bit mantissa
+}
+
+double simUniform(SimRandom* rng, double low, double high) {
+    return low + (high - low) * simUniform(rng);
+}
+
+double simGaussian(SimRandom* rng, double mean, double stddev) {
+    // Box-Muller, keeping the second value for the next call
+    if (rng->hasSpareGaussian) {
+        rng->hasSpareGaussian = false;
+        return mean + stddev * rng->spareGaussian;
+    }
+
+    double u1 = 1.0 - simUniform(rng);  // (0, 1], keeps log finite
+    double u2 = simUniform(rng);
+    double radius = std::sqrt(-2.0 * std::log(u1));
+    double angle = 6.283185307179586 * u2;  // 2*pi
+    rng->spareGaussian = radius * std::sin(angle);
+    rng->hasSpareGaussian = true;
+    return mean + stddev * radius * std::cos(angle);
+}
+
+static void jumpBy(SimRandom* rng, const uint64_t* polynomial) {
+    uint64_t jumped[4] = {0, 0, 0, 0};
+    for (int w = 0; w < 4; w++) {
+        uint64_t word = polynomial[w];
+        for (int bit = 0; bit < 64; bit++) {
+            if (word & (1ULL << bit)) {
+                for (int i = 0; i < 4; i++) {
+                    jumped[i] ^= rng->state[i];
+                }
+            }
+            simNext(rng);
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        rng->state[i] = jumped[i];
+    }
+}
+
+void simJump(SimRandom* rng) {
+    // Equivalent to 2^128 calls to simNext
+    static const uint64_t JUMP[] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+                                    0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+    jumpBy(rng, JUMP);
+}
+
+void simLongJump(SimRandom* rng) {
+    // Equivalent to 2^192 calls to simNext
+    static const uint64_t LONG_JUMP[] = {0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL,
+                                         0x77710069854EE241ULL, 0x39109BB02ACBE635ULL};
+    jumpBy(rng, LONG_JUMP);
+}
+
+static thread_local SimRandom threadRandom;
+static thread_local bool threadRandomSeeded = false;
+
+void setSimulationSeed(uint64_t seed) {
+    simulationSeed.store(seed);
+    nextStream.store(0);
+    threadRandomSeeded = false;
+}
+
+static void seedThreadRandom(uint64_t stream) {
+    seedSimRandom(&threadRandom, simulationSeed.load(), stream);
+    threadRandomSeeded = true;
+}
+
+void setSimulationStream(uint64_t stream) {
+    // Keep later automatic picks off a thread stream taken explicitly
+    if ((stream >> SIM_STREAM_INDEX_BITS) == SIM_STREAM_THREAD) {
+        uint64_t next = nextStream.load();
+        while (next <= stream && !nextStream.compare_exchange_weak(next, stream + 1)) {
+        }
+    }
+    seedThreadRandom(stream);
+}
+
+SimRandom* simRandom() {
+    if (!threadRandomSeeded) {
+        seedThreadRandom(simStream(SIM_STREAM_THREAD, nextStream.fetch_add(1)));
+    }
+    return &threadRandom;
+}
@@ -0,0 +1,60 @@
+/*
+ * Simulation Random Numbers for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * xoshiro256** generators with explicit seeds. Every thread draws from its
+ * own stream, so simulations are reproducible for a given seed and
+ * parallel runs never share generator state. Streams are 2^128 draws
+ * apart (xoshiro jump), so they cannot overlap in practice.
+ *
+ * The high bits of a stream number say who owns it (simStream()): each
+ * owner kind starts 2^192 draws in (xoshiro long jump), so athlete, shard
+ * and thread streams with the same index are still disjoint.
+ */
+
+#ifndef SIM_RANDOM_H
+#define SIM_RANDOM_H
+
+#include <cstdint>
+
+// Simulation RNG Configuration
+const uint64_t SIM_DEFAULT_SEED = 0x42A5E7B1C3D90F68ULL;
+const int SIM_STREAM_INDEX_BITS = 32;
+
+// Stream owners, in the bits above SIM_STREAM_INDEX_BITS
+enum SimStreamKind : uint64_t {
+    SIM_STREAM_THREAD,   // Per-thread streams behind simRandom()
+    SIM_STREAM_ATHLETE,  // A trainer's own generator, by athlete
+    SIM_STREAM_SHARD     // A hub shard thread, by shard index
+};
+
+inline uint64_t simStream(SimStreamKind kind, uint64_t index) {
+    return (static_cast<uint64_t>(kind) << SIM_STREAM_INDEX_BITS) |
+           (index & ((1ULL << SIM_STREAM_INDEX_BITS) - 1));
+}
+
+struct SimRandom {
+    uint64_t state[4];
+    double spareGaussian;
+    bool hasSpareGaussian;
+
+    SimRandom() : state{0, 0, 0, 0}, spareGaussian(0.0), hasSpareGaussian(false) {}
+};
+
+// Generator Functions
+void seedSimRandom(SimRandom* rng, uint64_t seed, uint64_t stream = 0);
+uint64_t simNext(SimRandom* rng);
+uint32_t simUniformInt(SimRandom* rng, uint32_t bound);   // [0, bound)
+double simUniform(SimRandom* rng);                        // [0, 1)
+double simUniform(SimRandom* rng, double low, double high);
+double simGaussian(SimRandom* rng, double mean, double stddev);
+void simJump(SimRandom* rng);
+void simLongJump(SimRandom* rng);
+
+// Per-thread streams; a thread that never picks one gets the next free
+// SIM_STREAM_THREAD index, never one a thread has picked explicitly
+void setSimulationSeed(uint64_t seed);
+void setSimulationStream(uint64_t stream);
+SimRandom* simRandom();
+
+#endif // SIM_RANDOM_H
@@ -0,0 +1,196 @@
+/*
+ * Pipeline Span Tracing for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "span_trace.h"
+#include "trace_log.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define SPAN_HAVE_SELF_PIPE 1
+#endif
+
+// Fields are relaxed atomics so a dump can read a ring while its owner
+// keeps writing; torn entries are detected from the head afterwards
+struct SpanSlot {
+    std::atomic<const char*> name;
+    std::atomic<uint64_t> startNs;
+    std::atomic<uint64_t> durationNs;
+};
+
+struct SpanBuffer {
+    SpanSlot slots[SPAN_BUFFER_RECORDS];
+    std::atomic<uint64_t> head;
+    std::atomic<const char*> threadName;
+    uint32_t thread;
+
+    SpanBuffer() : head(0), threadName(nullptr), thread(0) {}
+};
+
+struct SpanCopy {
+    const char* name;
+    uint64_t startNs;
+    uint64_t durationNs;
+};
+
+static std::mutex registryLock;
+static std::vector<std::shared_ptr<SpanBuffer>> spanBuffers;
+static volatile std::sig_atomic_t dumpRequested = 0;
+
+static SpanBuffer* threadSpanBuffer() {
+    static thread_local std::shared_ptr<SpanBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<SpanBuffer>();
+        std::lock_guard<std::mutex> guard(registryLock);
+        buffer->thread = static_cast<uint32_t>(spanBuffers.size());
+        spanBuffers.push_back(buffer);
+    }
+    return buffer.get();
+}
+
+ScopedSpan::ScopedSpan(const char* n) : name(n), startNs(traceTimestampNs()) {}
+
+ScopedSpan::~ScopedSpan() {
+    recordSpan(name, startNs, traceTimestampNs() - startNs);
+}
+
+void recordSpan(const char* name, uint64_t startNs, uint64_t durationNs) {
+    SpanBuffer* buffer = threadSpanBuffer();
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    SpanSlot& slot = buffer->slots[head & (SPAN_BUFFER_RECORDS - 1)];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startNs.store(startNs, std::memory_order_relaxed);
+    slot.durationNs.store(durationNs, std::memory_order_relaxed);
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void setSpanThreadName(const char* name) {
+    threadSpanBuffer()->threadName.store(name, std::memory_order_relaxed);
+}
+
+// Copies the live part of one ring, dropping slots overwritten meanwhile.
+// The writer fills slot head before publishing head + 1, so the slot that
+// position after reuses may be half written too.
+static void snapshotBuffer(SpanBuffer* buffer, std::vector<SpanCopy>* spans) {
+    spans->clear();
+    uint64_t head = buffer->head.load(std::memory_order_acquire);
+    uint64_t first = head > SPAN_BUFFER_RECORDS ? head - SPAN_BUFFER_RECORDS : 0;
+    for (uint64_t i = first; i < head; i++) {
+        const SpanSlot& slot = buffer->slots[i & (SPAN_BUFFER_RECORDS - 1)];
+        SpanCopy copy;
+        copy.name = slot.name.load(std::memory_order_relaxed);
+        copy.startNs = slot.startNs.load(std::memory_order_relaxed);
+        copy.durationNs = slot.durationNs.load(std::memory_order_relaxed);
+        spans->push_back(copy);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t after = buffer->head.load(std::memory_order_relaxed);
+    if (after + 1 > first + SPAN_BUFFER_RECORDS) {
+        size_t overwritten = static_cast<size_t>(after + 1 - first - SPAN_BUFFER_RECORDS);
+        spans->erase(spans->begin(), spans->begin() + std::min(overwritten, spans->size()));
+    }
+}
+
+bool dumpChromeTrace(const std::string& filename) {
+    std::vector<std::shared_ptr<SpanBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> guard(registryLock);
+        buffers = spanBuffers;
+    }
+
+    FILE* file = std::fopen(filename.c_str(), "w");
+    if (!file) return false;
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    std::vector<SpanCopy> spans;
+    spans.reserve(SPAN_BUFFER_RECORDS);
+    for (const std::shared_ptr<SpanBuffer>& buffer : buffers) {
+        const char* threadName = buffer->threadName.load(std::memory_order_relaxed);
+        if (threadName) {
+            std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                         "\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", buffer->thread, threadName);
+            first = false;
+        }
+
+        snapshotBuffer(buffer.get(), &spans);
+        for (const SpanCopy& span : spans) {
+            std::fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                         first ? "" : ",\n", span.name, span.startNs / 1000.0, span.durationNs / 1000.0,
+                         buffer->thread);
+            first = false;
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
+
+#if defined(SPAN_HAVE_SELF_PIPE)
+// The signal handler writes a byte here so a waiter can block in read()
+static int dumpPipe[2] = {-1, -1};
+#endif
+
+static void wakeDumpWaiter() {
+#if defined(SPAN_HAVE_SELF_PIPE)
+    if (dumpPipe[1] >= 0) {
+        ssize_t ignored = write(dumpPipe[1], "x", 1);  // Async-signal-safe; a full pipe already wakes
+        (void)ignored;
+    }
+#endif
+}
+
+static void handleDumpSignal(int) {
+    dumpRequested = 1;
+    wakeDumpWaiter();
+}
+
+void installTraceDumpSignal() {
+#if defined(SPAN_HAVE_SELF_PIPE)
+    if (dumpPipe[0] < 0 && pipe(dumpPipe) == 0) {
+        fcntl(dumpPipe[1], F_SETFL, fcntl(dumpPipe[1], F_GETFL) | O_NONBLOCK);
+    }
+#endif
+#if defined(SIGUSR1)
+    std::signal(SIGUSR1, handleDumpSignal);
+#endif
+}
+
+void requestTraceDump() {
+    dumpRequested = 1;
+    wakeDumpWaiter();
+}
+
+void waitForTraceDumpRequest() {
+#if defined(SPAN_HAVE_SELF_PIPE)
+    if (dumpPipe[0] >= 0) {
+        char wake[16];
+        while (!dumpRequested) {
+            ssize_t ignored = read(dumpPipe[0], wake, sizeof(wake));  // EINTR just loops
+            (void)ignored;
+        }
+        dumpRequested = 0;
+        return;
+    }
+#endif
+    while (!traceDumpRequested()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+bool traceDumpRequested() {
+    if (!dumpRequested) return false;
+    dumpRequested = 0;
+    return true;
+}
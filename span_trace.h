@@ -0,0 +1,41 @@
+/*
+ * Pipeline Span Tracing for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * ScopedSpan records the start and duration of a scope into a per-thread
+ * ring that keeps the most recent spans. dumpChromeTrace() writes them as
+ * Chrome trace event JSON for chrome://tracing or ui.perfetto.dev.
+ */
+
+#ifndef SPAN_TRACE_H
+#define SPAN_TRACE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Span Configuration
+const size_t SPAN_BUFFER_RECORDS = 8192;  // Per thread, power of two; oldest overwritten
+const std::string CHROME_TRACE_FILE = "trainer_trace.json";
+
+// Records the lifetime of the object as a span; name must be a string literal
+struct ScopedSpan {
+    const char* name;
+    uint64_t startNs;
+
+    explicit ScopedSpan(const char* n);
+    ~ScopedSpan();
+};
+
+// Function Declarations
+void recordSpan(const char* name, uint64_t startNs, uint64_t durationNs);
+void setSpanThreadName(const char* name);
+bool dumpChromeTrace(const std::string& filename = CHROME_TRACE_FILE);
+
+// On-demand dumps (SIGUSR1 on POSIX)
+void installTraceDumpSignal();
+void requestTraceDump();
+bool traceDumpRequested();
+void waitForTraceDumpRequest();  // Blocks without polling where a self-pipe is available
+
+#endif // SPAN_TRACE_H
@@ -0,0 +1,61 @@
+/*
+ * Spectral Motion Features for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "spectral_features.h"
+#include <algorithm>
+#include <cmath>
+
+const double PI = 3.14159265358979323846;
+const double SDFT_DAMPING = 0.999999;  // Keeps rounding error from accumulating
+
+bool initSlidingDft(SlidingDft* dft, double sampleRate, double lowHz, double highHz, int window) {
+    if (window < 8 || window > SDFT_MAX_WINDOW || sampleRate <= 0 || lowHz <= 0 || highHz < lowHz) {
+        return false;
+    }
+
+    int low = static_cast<int>(std::ceil(lowHz * window / sampleRate));
+    int high = std::min(static_cast<int>(std::floor(highHz * window / sampleRate)), window / 2 - 1);
+    low = std::max(low, 1);
+    if (high < low || high - low + 3 > SDFT_MAX_BINS) return false;
+
+    *dft = SlidingDft();
+    dft->window = window;
+    dft->firstBin = low - 1;
+    dft->binCount = high - low + 3;
+    for (int b = 0; b < dft->binCount; b++) {
+        dft->twiddle[b] = std::polar(SDFT_DAMPING, 2.0 * PI * (dft->firstBin + b) / window);
+    }
+    dft->dampingN = std::pow(SDFT_DAMPING, window);
+    return true;
+}
+
+void slidingDftUpdate(SlidingDft* dft, const Vector3D& gyro) {
+    // X(n) = x(n) - r^N x(n - N) + r e^(j 2 pi k / N) X(n - 1)
+    const double values[3] = {gyro.x, gyro.y, gyro.z};
+    for (int axis = 0; axis < 3; axis++) {
+        double oldest = dft->filled == dft->window ? dft->history[axis][dft->head] : 0.0;
+        double delta = values[axis] - dft->dampingN * oldest;
+        std::complex<double>* bins = dft->bins[axis];
+        for (int b = 0; b < dft->binCount; b++) {
+            bins[b] = dft->twiddle[b] * bins[b] + delta;
+        }
+        dft->history[axis][dft->head] = values[axis];
+    }
+    dft->head = (dft->head + 1) % dft->window;
+    if (dft->filled < dft->window) dft->filled++;
+}
+
+double slidingDftBandPower(const SlidingDft* dft) {
+    // Hann window as 0.5 X(k) - 0.25 (X(k - 1) + X(k + 1)); scaled so a
+    // sinusoid of amplitude A in the band reads A^2 / 2
+    double sum = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        const std::complex<double>* bins = dft->bins[axis];
+        for (int b = 1; b < dft->binCount - 1; b++) {
+            sum += std::norm(0.5 * bins[b] - 0.25 * (bins[b - 1] + bins[b + 1]));
+        }
+    }
+    return sum * 16.0 / (3.0 * dft->window * dft->window);
+}
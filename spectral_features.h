@@ -0,0 +1,46 @@
+/*
+ * Spectral Motion Features for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * A sliding DFT over the three gyro axes that keeps only the bins of one
+ * frequency band (e.g. 8-12 Hz physiological tremor). Each sample updates
+ * every kept bin in O(1), so it is cheap enough to run on every IMU all
+ * the time. A Hann window is applied in the frequency domain from the
+ * neighbouring bins, which stops slow arm motion leaking into the band.
+ */
+
+#ifndef SPECTRAL_FEATURES_H
+#define SPECTRAL_FEATURES_H
+
+#include <complex>
+#include <cstddef>
+#include "sensors.h"
+
+// Spectral Configuration
+const int SDFT_WINDOW = 64;        // Samples (0.64 s at SAMPLE_RATE)
+const int SDFT_MAX_WINDOW = 256;
+const int SDFT_MAX_BINS = 16;      // Band bins plus one guard bin each side
+const double TREMOR_BAND_LOW = 8.0;    // Hz
+const double TREMOR_BAND_HIGH = 12.0;  // Hz
+
+struct SlidingDft {
+    int window;
+    int firstBin;  // Lowest computed bin; the band is firstBin + 1 .. firstBin + binCount - 2
+    int binCount;
+    std::complex<double> twiddle[SDFT_MAX_BINS];
+    std::complex<double> bins[3][SDFT_MAX_BINS];  // Per gyro axis
+    double history[3][SDFT_MAX_WINDOW];
+    double dampingN;  // SDFT_DAMPING^window
+    int head;
+    int filled;
+
+    SlidingDft() : window(0), firstBin(0), binCount(0), dampingN(1.0), head(0), filled(0) {}
+};
+
+// Function Declarations
+bool initSlidingDft(SlidingDft* dft, double sampleRate, double lowHz, double highHz,
+                    int window = SDFT_WINDOW);
+void slidingDftUpdate(SlidingDft* dft, const Vector3D& gyro);
+double slidingDftBandPower(const SlidingDft* dft);  // Mean squared amplitude, (deg/s)^2
+
+#endif // SPECTRAL_FEATURES_H
@@ -0,0 +1,100 @@
+/*
+ * Work-Stealing Thread Pool for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "thread_pool.h"
+
+// Index of the pool worker running on this thread, -1 elsewhere
+static thread_local int currentWorker = -1;
+static thread_local const WorkStealingPool* currentPool = nullptr;
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount)
+    : workerCount(0), queued(0), pending(0), nextQueue(0), stopping(false) {
+    if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+    workerCount = threadCount;
+
+    for (unsigned i = 0; i < threadCount; i++) {
+        queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+    for (unsigned i = 0; i < threadCount; i++) {
+        workers.push_back(std::thread(&WorkStealingPool::workerLoop, this, i));
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    // Tasks spawned by a worker stay on its own deque for locality
+    unsigned index = currentPool == this ? static_cast<unsigned>(currentWorker)
+                                         : nextQueue++ % size();
+    pending++;
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        queued++;
+    }
+    {
+        std::lock_guard<std::mutex> guard(queues[index]->lock);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    workAvailable.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> guard(stateLock);
+    allDone.wait(guard, [this] { return pending == 0; });
+}
+
+bool WorkStealingPool::popLocal(unsigned index, std::function<void()>* task) {
+    WorkerQueue& queue = *queues[index];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (queue.tasks.empty()) return false;
+    *task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned index, std::function<void()>* task) {
+    for (unsigned offset = 1; offset < size(); offset++) {
+        WorkerQueue& victim = *queues[(index + offset) % size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (victim.tasks.empty()) continue;
+        *task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(unsigned index) {
+    currentWorker = static_cast<int>(index);
+    currentPool = this;
+
+    std::function<void()> task;
+    while (true) {
+        if (popLocal(index, &task) || steal(index, &task)) {
+            queued--;
+            task();
+            task = nullptr;
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> guard(stateLock);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(stateLock);
+        workAvailable.wait(guard, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) return;
+    }
+}
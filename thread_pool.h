@@ -0,0 +1,52 @@
+/*
+ * Work-Stealing Thread Pool for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Each worker owns a task deque: it pops its own newest task and, when
+ * empty, steals the oldest task from another worker.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threadCount = 0);  // 0: one per core
+    ~WorkStealingPool();
+
+    void submit(std::function<void()> task);
+    void wait();  // Blocks until every submitted task has finished
+    unsigned size() const { return workerCount; }
+
+private:
+    struct WorkerQueue {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool popLocal(unsigned index, std::function<void()>* task);
+    bool steal(unsigned index, std::function<void()>* task);
+    void workerLoop(unsigned index);
+
+    unsigned workerCount;  // Fixed before any worker starts; workers is still growing then
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex stateLock;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    std::atomic<size_t> queued;   // Tasks sitting in a deque
+    std::atomic<size_t> pending;  // Tasks submitted but not finished
+    std::atomic<unsigned> nextQueue;
+    bool stopping;
+};
+
+#endif // THREAD_POOL_H
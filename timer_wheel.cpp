@@ -0,0 +1,207 @@
+/*
+ * Hierarchical Timer Wheel for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "timer_wheel.h"
+#include <algorithm>
+
+const int TIMER_SLOT_MASK = TIMER_WHEEL_SLOTS - 1;
+const uint64_t TIMER_MAX_DELAY = (1ULL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1;
+
+// Slot Lists
+
+static void setBusy(TimerWheel* wheel, int bucket, bool busy) {
+    uint64_t& word = wheel->busy[bucket / TIMER_WHEEL_SLOTS][(bucket & TIMER_SLOT_MASK) / 64];
+    uint64_t bit = 1ULL << (bucket & 63);
+    word = busy ? word | bit : word & ~bit;
+}
+
+// Level and slot for a timer: the lowest level whose span still reaches it
+static int bucketFor(const TimerWheel* wheel, uint64_t expires) {
+    uint64_t delta = expires > wheel->now ? expires - wheel->now : 0;
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1ULL << (TIMER_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    int slot = static_cast<int>(expires >> (TIMER_WHEEL_BITS * level)) & TIMER_SLOT_MASK;
+    return level * TIMER_WHEEL_SLOTS + slot;
+}
+
+static void linkNode(TimerWheel* wheel, int index) {
+    TimerNode& node = wheel->nodes[index];
+    int bucket = bucketFor(wheel, node.expires);
+    node.bucket = static_cast<int16_t>(bucket);
+    node.prev = -1;
+    node.next = wheel->heads[bucket];
+    if (node.next >= 0) wheel->nodes[node.next].prev = index;
+    wheel->heads[bucket] = index;
+    setBusy(wheel, bucket, true);
+}
+
+static void unlinkNode(TimerWheel* wheel, int index) {
+    TimerNode& node = wheel->nodes[index];
+    if (node.prev >= 0) {
+        wheel->nodes[node.prev].next = node.next;
+    } else {
+        wheel->heads[node.bucket] = node.next;
+        if (node.next < 0) setBusy(wheel, node.bucket, false);
+    }
+    if (node.next >= 0) wheel->nodes[node.next].prev = node.prev;
+    node.bucket = -1;
+}
+
+static void freeNode(TimerWheel* wheel, int index) {
+    TimerNode& node = wheel->nodes[index];
+    node.generation++;
+    node.callback = nullptr;
+    node.context = nullptr;
+    node.next = wheel->freeNode;
+    wheel->freeNode = index;
+    wheel->pending--;
+}
+
+static int nodeIndex(const TimerWheel* wheel, TimerId id) {
+    int index = static_cast<int>(id & 0xFFFF) - 1;
+    if (index < 0 || index >= static_cast<int>(wheel->nodes.size())) return -1;
+    const TimerNode& node = wheel->nodes[index];
+    if (node.bucket < 0 || node.generation != (id >> 16)) return -1;
+    return index;
+}
+
+// Distance from `from` to the first busy slot at or after it, wrapping
+// round the level; -1 if the level is empty
+static int nextBusyOffset(const uint64_t* busy, int from) {
+    for (int scanned = 0; scanned < TIMER_WHEEL_SLOTS;) {
+        int slot = (from + scanned) & TIMER_SLOT_MASK;
+        uint64_t word = busy[slot / 64] >> (slot & 63);
+        if (word) return scanned + __builtin_ctzll(word);
+        scanned += 64 - (slot & 63);
+    }
+    return -1;
+}
+
+// Public API
+
+void initTimerWheel(TimerWheel* wheel, uint64_t now, int capacity) {
+    capacity = std::max(1, std::min(capacity, 0xFFFE));
+    wheel->now = now;
+    std::fill(std::begin(wheel->heads), std::end(wheel->heads), -1);
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        std::fill(std::begin(wheel->busy[level]), std::end(wheel->busy[level]), 0);
+    }
+    wheel->nodes.assign(capacity, TimerNode());
+    for (int index = 0; index < capacity; index++) {
+        wheel->nodes[index].next = index + 1 < capacity ? index + 1 : -1;
+    }
+    wheel->freeNode = 0;
+    wheel->pending = 0;
+}
+
+static TimerId addTimer(TimerWheel* wheel, uint64_t delay, uint32_t period, TimerCallback callback,
+                        void* context) {
+    if (wheel->freeNode < 0 || !callback) return 0;
+
+    int index = wheel->freeNode;
+    TimerNode& node = wheel->nodes[index];
+    wheel->freeNode = node.next;
+    wheel->pending++;
+
+    node.expires = wheel->now + std::max<uint64_t>(1, std::min(delay, TIMER_MAX_DELAY));
+    node.period = period;
+    node.callback = callback;
+    node.context = context;
+    linkNode(wheel, index);
+    return (static_cast<TimerId>(node.generation) << 16) | static_cast<TimerId>(index + 1);
+}
+
+TimerId scheduleTimer(TimerWheel* wheel, uint64_t delay, TimerCallback callback, void* context) {
+    return addTimer(wheel, delay, 0, callback, context);
+}
+
+TimerId schedulePeriodicTimer(TimerWheel* wheel, uint64_t period, TimerCallback callback, void* context) {
+    if (period == 0) return 0;
+    period = std::min(period, TIMER_MAX_DELAY);
+    return addTimer(wheel, period, static_cast<uint32_t>(period), callback, context);
+}
+
+bool cancelTimer(TimerWheel* wheel, TimerId id) {
+    int index = nodeIndex(wheel, id);
+    if (index < 0) return false;
+    unlinkNode(wheel, index);
+    freeNode(wheel, index);
+    return true;
+}
+
+bool timerPending(const TimerWheel* wheel, TimerId id) {
+    return nodeIndex(wheel, id) >= 0;
+}
+
+// Re-files the slot of `level` that the wheel has just reached into the
+// levels below; higher levels cascade first when their index wraps too
+static void cascade(TimerWheel* wheel, int level) {
+    if (level >= TIMER_WHEEL_LEVELS) return;
+    int slot = static_cast<int>(wheel->now >> (TIMER_WHEEL_BITS * level)) & TIMER_SLOT_MASK;
+    if (slot == 0) cascade(wheel, level + 1);
+
+    int bucket = level * TIMER_WHEEL_SLOTS + slot;
+    while (wheel->heads[bucket] >= 0) {
+        int index = wheel->heads[bucket];
+        unlinkNode(wheel, index);
+        linkNode(wheel, index);  // Now less than one slot of this level away
+    }
+}
+
+// Fires one timer at a time so callbacks may cancel anything, including
+// other timers due on this tick
+static int fireSlot(TimerWheel* wheel, int slot) {
+    int fired = 0;
+    while (wheel->heads[slot] >= 0) {
+        int index = wheel->heads[slot];
+        TimerNode& node = wheel->nodes[index];
+        TimerCallback callback = node.callback;
+        void* context = node.context;
+
+        unlinkNode(wheel, index);
+        if (node.period > 0) {
+            node.expires = wheel->now + node.period;
+            linkNode(wheel, index);
+        } else {
+            freeNode(wheel, index);
+        }
+        callback(wheel, context);
+        fired++;
+    }
+    return fired;
+}
+
+int advanceTimerWheel(TimerWheel* wheel, uint64_t now) {
+    int fired = 0;
+    while (wheel->now < now) {
+        // Jump straight to the next busy tick or level boundary
+        uint64_t boundary = (wheel->now | TIMER_SLOT_MASK) + 1;
+        uint64_t next = std::min(now, boundary);
+        int offset = nextBusyOffset(wheel->busy[0], static_cast<int>(wheel->now + 1) & TIMER_SLOT_MASK);
+        if (offset >= 0) next = std::min(next, wheel->now + 1 + offset);
+
+        wheel->now = next;
+        if ((next & TIMER_SLOT_MASK) == 0) cascade(wheel, 1);
+        fired += fireSlot(wheel, static_cast<int>(next) & TIMER_SLOT_MASK);
+    }
+    return fired;
+}
+
+// Upper levels only report when their next busy slot cascades, which is
+// never after the timers in it expire
+uint64_t nextTimerExpiry(const TimerWheel* wheel) {
+    if (wheel->pending == 0) return UINT64_MAX;
+
+    uint64_t earliest = UINT64_MAX;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        int shift = TIMER_WHEEL_BITS * level;
+        uint64_t window = wheel->now >> shift;
+        int offset = nextBusyOffset(wheel->busy[level], static_cast<int>(window + 1) & TIMER_SLOT_MASK);
+        if (offset >= 0) earliest = std::min(earliest, (window + 1 + offset) << shift);
+    }
+    return earliest;
+}
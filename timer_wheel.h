@@ -0,0 +1,70 @@
+/*
+ * Hierarchical Timer Wheel for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Owns every timed event of one trainer: motor off-times, pattern steps,
+ * button debounce and the periodic status, print and battery jobs. Four
+ * levels of 256 slots at a 1 ms tick cover 49 days; a timer sits in the
+ * level matching how far away it is and cascades down as its slot comes
+ * round. Insert and cancel are O(1) on a doubly linked slot list, and
+ * advancing skips empty slots with a per-level bitmap, so a tick costs
+ * only the timers that fire or cascade. Nodes come from a fixed pool.
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstdint>
+#include <vector>
+
+// Wheel Configuration
+const int TIMER_WHEEL_BITS = 8;
+const int TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_BITS;  // Per level
+const int TIMER_WHEEL_LEVELS = 4;                      // Ticks up to 2^32 ms
+const int TIMER_WHEEL_CAPACITY = 32;                   // Pending timers per wheel
+
+struct TimerWheel;
+
+// Runs once the timer expires; may schedule or cancel timers, including
+// rescheduling itself
+typedef void (*TimerCallback)(TimerWheel* wheel, void* context);
+
+// 0 is never a valid id; ids of fired or cancelled timers go stale, so
+// cancelling one late is harmless
+typedef uint32_t TimerId;
+
+struct TimerNode {
+    uint64_t expires;    // Tick
+    uint32_t period;     // Ticks; 0 for one-shot
+    uint16_t generation;
+    int16_t bucket;      // level * TIMER_WHEEL_SLOTS + slot, -1 when free
+    int next;
+    int prev;
+    TimerCallback callback;
+    void* context;
+
+    TimerNode() : expires(0), period(0), generation(0), bucket(-1), next(-1), prev(-1),
+                  callback(nullptr), context(nullptr) {}
+};
+
+struct TimerWheel {
+    uint64_t now;  // Last tick advanced to (ms)
+    int heads[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+    uint64_t busy[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS / 64];  // Non-empty slots
+    std::vector<TimerNode> nodes;
+    int freeNode;
+    int pending;
+
+    TimerWheel() : now(0), freeNode(-1), pending(0) {}
+};
+
+// Function Declarations
+void initTimerWheel(TimerWheel* wheel, uint64_t now, int capacity = TIMER_WHEEL_CAPACITY);
+TimerId scheduleTimer(TimerWheel* wheel, uint64_t delay, TimerCallback callback, void* context);
+TimerId schedulePeriodicTimer(TimerWheel* wheel, uint64_t period, TimerCallback callback, void* context);
+bool cancelTimer(TimerWheel* wheel, TimerId id);
+bool timerPending(const TimerWheel* wheel, TimerId id);
+int advanceTimerWheel(TimerWheel* wheel, uint64_t now);  // Returns how many timers fired
+uint64_t nextTimerExpiry(const TimerWheel* wheel);        // Never late; UINT64_MAX when empty
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,227 @@
+/*
+ * Binary Trace Logging for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "trace_log.h"
+#include "span_trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Indexed by TraceEvent; printf formats taking the record's doubles
+static const char* const TRACE_FORMATS[] = {
+    "Status: STANDBY (LED blink)",
+    "BNO055 - X: %.0f Y: %.0f Z: %.0f",
+    "MPU6050 - AX: %.0f AY: %.0f AZ: %.0f",
+    "Calibration Mode: Take 10 successful free throws",
+    "Calibration shot %.0f recorded",
+    "Calibration complete!\nAverage elbow angle: %g",
+    "Please calibrate first!",
+    "Shot analyzed - check form feedback",
+    "Data Review Mode\nTotal shots: %.0f, average score %.1f, %.0f%% made",
+    "Calibrated elbow angle: %g",
+    "Haptic: Elbow angle correction needed",
+    "Haptic: Wrist angle correction needed",
+    "Haptic: Good form!",
+    "Switched to Training Mode",
+    "Switched to Data Review Mode",
+    "Switched to Standby Mode",
+    "Shot outcome recorded",
+    "Battery voltage: %gV",
+    "Low battery warning!",
+    "Allocation of %.0f bytes in a no-allocation section",
+    "Haptic emergency stop: motor on pin %.0f at %.1f C above ambient",
+    "Haptic derating: motor on pin %.0f at %.1f C above ambient, %.0f%% duty",
+    "Shot log queue full: shot not saved",
+    "Closest earlier shot: #%.0f, similarity %.2f",
+    "Haptic feedback resumed: motors below %.0f C above ambient",
+};
+static_assert(sizeof(TRACE_FORMATS) / sizeof(TRACE_FORMATS[0]) == TRACE_EVENT_COUNT,
+              "every TraceEvent needs a format");
+
+// Single-producer ring owned by one thread, drained by the logger thread
+struct TraceBuffer {
+    TraceRecord records[TRACE_BUFFER_RECORDS];
+    std::atomic<uint64_t> head;  // Written by the owning thread
+    std::atomic<uint64_t> tail;  // Written by the logger thread
+    std::atomic<uint64_t> dropped;
+    uint32_t thread;
+
+    TraceBuffer() : head(0), tail(0), dropped(0), thread(0) {}
+};
+
+static std::mutex registryLock;
+static std::vector<std::shared_ptr<TraceBuffer>> traceBuffers;
+static std::thread loggerThread;
+static std::mutex loggerLock;
+static std::condition_variable loggerWake;
+static bool loggerRunning = false;
+
+static TraceBuffer* threadTraceBuffer() {
+    static thread_local std::shared_ptr<TraceBuffer> buffer;
+    if (!buffer) {
+        // Registration is the only locked step, once per thread
+        buffer = std::make_shared<TraceBuffer>();
+        std::lock_guard<std::mutex> guard(registryLock);
+        buffer->thread = static_cast<uint32_t>(traceBuffers.size());
+        traceBuffers.push_back(buffer);
+    }
+    return buffer.get();
+}
+
+uint64_t traceTimestampNs() {
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+static void writeRecord(TraceEvent event, int argCount, double arg0, double arg1, double arg2) {
+    TraceBuffer* buffer = threadTraceBuffer();
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    if (head - buffer->tail.load(std::memory_order_acquire) >= TRACE_BUFFER_RECORDS) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;  // Never block the caller; the logger is behind
+    }
+
+    TraceRecord& record = buffer->records[head & (TRACE_BUFFER_RECORDS - 1)];
+    record.timestamp = traceTimestampNs();
+    record.event = event;
+    record.argCount = static_cast<uint16_t>(argCount);
+    record.thread = buffer->thread;
+    record.args[0] = arg0;
+    record.args[1] = arg1;
+    record.args[2] = arg2;
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void traceLog(TraceEvent event) {
+    writeRecord(event, 0, 0, 0, 0);
+}
+
+void traceLog(TraceEvent event, double arg0) {
+    writeRecord(event, 1, arg0, 0, 0);
+}
+
+void traceLog(TraceEvent event, double arg0, double arg1) {
+    writeRecord(event, 2, arg0, arg1, 0);
+}
+
+void traceLog(TraceEvent event, double arg0, double arg1, double arg2) {
+    writeRecord(event, 3, arg0, arg1, arg2);
+}
+
+size_t formatTraceRecord(const TraceRecord* record, char* buffer, size_t size) {
+    int written;
+    if (record->event < TRACE_EVENT_COUNT) {
+        written = std::snprintf(buffer, size, TRACE_FORMATS[record->event],
+                                record->args[0], record->args[1], record->args[2]);
+    } else {
+        written = std::snprintf(buffer, size, "Unknown trace event %u",
+                                static_cast<unsigned>(record->event));
+    }
+    return written < 0 ? 0 : std::min(static_cast<size_t>(written), size - 1);
+}
+
+// Drains every ring and prints the records in timestamp order; returns
+// how many there were
+static size_t drainTraceBuffers(std::vector<TraceRecord>* batch) {
+    ScopedSpan span("drainTraceBuffers");
+    batch->clear();
+    {
+        std::lock_guard<std::mutex> guard(registryLock);
+        for (const std::shared_ptr<TraceBuffer>& buffer : traceBuffers) {
+            uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+            uint64_t head = buffer->head.load(std::memory_order_acquire);
+            for (; tail != head; tail++) {
+                batch->push_back(buffer->records[tail & (TRACE_BUFFER_RECORDS - 1)]);
+            }
+            buffer->tail.store(tail, std::memory_order_release);
+        }
+    }
+
+    std::sort(batch->begin(), batch->end(), [](const TraceRecord& a, const TraceRecord& b) {
+        return a.timestamp < b.timestamp;
+    });
+
+    char line[256];
+    for (const TraceRecord& record : *batch) {
+        size_t length = formatTraceRecord(&record, line, sizeof(line) - 1);
+        line[length++] = '\n';
+        std::fwrite(line, 1, length, stdout);
+    }
+    if (!batch->empty()) std::fflush(stdout);
+    return batch->size();
+}
+
+static void loggerLoop() {
+    setSpanThreadName("trace_logger");
+    std::vector<TraceRecord> batch;
+    batch.reserve(TRACE_BUFFER_RECORDS);
+
+    // Back off while the rings stay empty so an idle system rarely wakes
+    int interval = TRACE_DRAIN_INTERVAL;
+    std::unique_lock<std::mutex> guard(loggerLock);
+    while (loggerRunning) {
+        loggerWake.wait_for(guard, std::chrono::milliseconds(interval));
+        guard.unlock();
+        if (drainTraceBuffers(&batch) > 0) {
+            interval = TRACE_DRAIN_INTERVAL;
+        } else {
+            interval = std::min(interval * 2, TRACE_IDLE_DRAIN_INTERVAL);
+        }
+        guard.lock();
+    }
+    guard.unlock();
+    drainTraceBuffers(&batch);
+}
+
+void attachTraceThread() {
+    threadTraceBuffer();
+}
+
+void startTraceLogger() {
+    attachTraceThread();
+    std::lock_guard<std::mutex> guard(loggerLock);
+    if (loggerRunning) return;
+    loggerRunning = true;
+    loggerThread = std::thread(loggerLoop);
+}
+
+void stopTraceLogger() {
+    {
+        std::lock_guard<std::mutex> guard(loggerLock);
+        if (!loggerRunning) return;
+        loggerRunning = false;
+    }
+    loggerWake.notify_all();
+    loggerThread.join();
+}
+
+void flushTraceLog() {
+    loggerWake.notify_all();
+}
+
+size_t traceQueueDepth() {
+    std::lock_guard<std::mutex> guard(registryLock);
+    size_t depth = 0;
+    for (const std::shared_ptr<TraceBuffer>& buffer : traceBuffers) {
+        depth += buffer->head.load(std::memory_order_relaxed) - buffer->tail.load(std::memory_order_relaxed);
+    }
+    return depth;
+}
+
+uint64_t traceDroppedRecords() {
+    std::lock_guard<std::mutex> guard(registryLock);
+    uint64_t dropped = 0;
+    for (const std::shared_ptr<TraceBuffer>& buffer : traceBuffers) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
@@ -0,0 +1,77 @@
+/*
+ * Binary Trace Logging for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * traceLog() copies an event id, a timestamp and raw arguments into a
+ * per-thread ring buffer. A background thread drains the rings and does
+ * the text formatting, so the calling thread never formats, locks or
+ * flushes.
+ */
+
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Trace Configuration
+const size_t TRACE_BUFFER_RECORDS = 4096;  // Per thread, power of two
+const int TRACE_MAX_ARGS = 3;
+const int TRACE_DRAIN_INTERVAL = 10;       // ms between background drains
+const int TRACE_IDLE_DRAIN_INTERVAL = 640; // ms; drains back off to this while nothing is logged
+
+// Trace Events (formats live in trace_log.cpp)
+enum TraceEvent : uint16_t {
+    TRACE_STATUS_STANDBY,
+    TRACE_SENSOR_BNO055,
+    TRACE_SENSOR_MPU6050,
+    TRACE_CALIBRATION_MODE,
+    TRACE_CALIBRATION_SHOT,
+    TRACE_CALIBRATION_COMPLETE,
+    TRACE_CALIBRATION_REQUIRED,
+    TRACE_SHOT_ANALYZED,
+    TRACE_DATA_REVIEW,
+    TRACE_DATA_REVIEW_CALIBRATION,
+    TRACE_HAPTIC_ELBOW,
+    TRACE_HAPTIC_WRIST,
+    TRACE_HAPTIC_GOOD_FORM,
+    TRACE_STATE_TRAINING,
+    TRACE_STATE_DATA_REVIEW,
+    TRACE_STATE_STANDBY,
+    TRACE_SHOT_OUTCOME,
+    TRACE_BATTERY_VOLTAGE,
+    TRACE_BATTERY_LOW,
+    TRACE_CRITICAL_ALLOCATION,
+    TRACE_HAPTIC_EMERGENCY_STOP,
+    TRACE_HAPTIC_DERATING,
+    TRACE_SHOT_LOG_FULL,
+    TRACE_SHOT_MATCH,
+    TRACE_HAPTIC_RESUMED,
+    TRACE_EVENT_COUNT
+};
+
+struct TraceRecord {
+    uint64_t timestamp;  // ns since the trace clock started
+    uint16_t event;
+    uint16_t argCount;
+    uint32_t thread;
+    double args[TRACE_MAX_ARGS];
+};
+
+// Function Declarations
+void traceLog(TraceEvent event);
+void traceLog(TraceEvent event, double arg0);
+void traceLog(TraceEvent event, double arg0, double arg1);
+void traceLog(TraceEvent event, double arg0, double arg1, double arg2);
+uint64_t traceTimestampNs();
+void startTraceLogger();
+void attachTraceThread();  // Creates the calling thread's ring now, not on its first traceLog
+void stopTraceLogger();
+void flushTraceLog();
+size_t formatTraceRecord(const TraceRecord* record, char* buffer, size_t size);
+
+// Statistics
+size_t traceQueueDepth();
+uint64_t traceDroppedRecords();
+
+#endif // TRACE_LOG_H
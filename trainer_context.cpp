@@ -0,0 +1,161 @@
+/*
+ * Per-Athlete Trainer Context for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "trainer_context.h"
+#include "trace_log.h"
+#include "span_trace.h"
+#include <algorithm>
+#include <chrono>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+void initTrainerContext(TrainerContext* trainer, int athlete, uint64_t seed) {
+    trainer->athlete = athlete;
+    seedSimRandom(&trainer->rng, seed, simStream(SIM_STREAM_ATHLETE, athlete));
+    initHapticMotors(&trainer->motors, HAPTIC_MOTOR_PINS, HAPTIC_MOTOR_COUNT);
+    for (I2cBus& bus : trainer->buses) {
+        initI2cBus(&bus, I2C_BUS_CLOCK);
+    }
+    initDrv2605Array(&trainer->hapticDrivers, &trainer->buses[IMU_BUS_DRV], HAPTIC_MOTOR_COUNT,
+                     HAPTIC_DRIVER_CHANNEL);
+    attachHapticDriver(&trainer->motors, &trainer->hapticDrivers);
+    initTimerWheel(&trainer->timerWheel, traceTimestampNs() / 1000000);
+    initHapticQueue(&trainer->hapticQueue);
+
+    ShotGeneratorConfig generatorConfig;
+    generatorConfig.sampleRate = CAPTURE_SAMPLE_RATE;
+    generatorConfig.glitchRate = 0.001;
+    initShotGenerator(&trainer->shotGenerator, generatorConfig, simNext(&trainer->rng));
+    initFirDecimator(&trainer->shotDecimator, CAPTURE_SAMPLE_RATE / SAMPLE_RATE, CAPTURE_SAMPLE_RATE,
+                     FIR_DEFAULT_CUTOFF * SAMPLE_RATE);
+    initHampelFilter(&trainer->spikeFilter);
+    for (int imu = 0; imu < IMU_COUNT; imu++) {
+        initSlidingDft(&trainer->tremorDfts[imu], SAMPLE_RATE, TREMOR_BAND_LOW, TREMOR_BAND_HIGH);
+    }
+    initRateController(&trainer->rateController);
+    limitSampleRate(&trainer->rateController, imuSampleRateLimit(I2C_BUS_CLOCK));
+
+    size_t shotSamples = maxShotSamples(&trainer->shotGenerator);
+    for (int imu = 0; imu < IMU_COUNT; imu++) {
+        trainer->shotStreams[imu].reserve(shotSamples);
+    }
+    trainer->cleanedShot.reserve(shotSamples);
+    trainer->forearmShot.reserve(shotSamples / trainer->shotDecimator.ratio + 1);
+    trainer->forearmTremor.reserve(shotSamples / trainer->shotDecimator.ratio + 1);
+    trainer->shotSegments.reserve(SHOT_SEGMENT_CAPACITY);
+}
+
+// Hub
+
+static void pinToCore(int shard) {
+#if defined(__linux__)
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(shard % cores, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)shard;
+#endif
+}
+
+// Steps every context that is due or has events, then blocks until the
+// next deadline or notifyTrainer()
+static void shardLoop(TrainerHub* hub, TrainerShard* shard) {
+    pinToCore(shard->index);
+    setSpanThreadName("trainer_shard");
+    attachTraceThread();
+    setSimulationStream(simStream(SIM_STREAM_SHARD, shard->index));
+
+    uint64_t start = traceTimestampNs();
+    for (TrainerContext* trainer : shard->trainers) {
+        if (hub->setup) hub->setup(trainer);
+        trainer->nextStepNs = start;
+    }
+
+    while (hub->running.load(std::memory_order_relaxed)) {
+        uint64_t now = traceTimestampNs();
+        uint64_t wake = UINT64_MAX;
+        for (TrainerContext* trainer : shard->trainers) {
+            uint32_t events = trainer->pendingEvents.exchange(0, std::memory_order_acquire);
+            if (events != 0 || now >= trainer->nextStepNs) {
+                trainer->nextStepNs = hub->step(trainer, events);
+                shard->steps.fetch_add(1, std::memory_order_relaxed);
+            }
+            wake = std::min(wake, trainer->nextStepNs);
+        }
+
+        std::unique_lock<std::mutex> guard(shard->wakeLock);
+        auto woken = [hub, shard] { return shard->notified || !hub->running.load(); };
+        now = traceTimestampNs();
+        if (wake == UINT64_MAX) {
+            shard->wake.wait(guard, woken);
+        } else if (wake > now) {
+            shard->wake.wait_for(guard, std::chrono::nanoseconds(wake - now), woken);
+        }
+        shard->notified = false;
+        shard->wakeups.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool startTrainerHub(TrainerHub* hub, int athletes, TrainerSetup setup, TrainerStep step, uint64_t seed,
+                     unsigned shardCount) {
+    if (hub->running.load() || athletes < 1 || athletes > MAX_ATHLETES || !step) return false;
+
+    if (shardCount == 0) shardCount = std::max(1u, std::thread::hardware_concurrency());
+    shardCount = std::min(shardCount, static_cast<unsigned>(athletes));
+
+    hub->setup = setup;
+    hub->step = step;
+    hub->trainers.clear();
+    hub->shards.clear();
+    for (int athlete = 0; athlete < athletes; athlete++) {
+        hub->trainers.push_back(std::unique_ptr<TrainerContext>(new TrainerContext()));
+        initTrainerContext(hub->trainers.back().get(), athlete, seed);
+    }
+    for (unsigned i = 0; i < shardCount; i++) {
+        hub->shards.push_back(std::unique_ptr<TrainerShard>(new TrainerShard()));
+        hub->shards.back()->index = static_cast<int>(i);
+        hub->shards.back()->notified = false;
+        hub->shards.back()->steps.store(0);
+        hub->shards.back()->wakeups.store(0);
+    }
+    for (int athlete = 0; athlete < athletes; athlete++) {
+        hub->trainers[athlete]->shard = athlete % shardCount;
+        hub->shards[athlete % shardCount]->trainers.push_back(hub->trainers[athlete].get());
+    }
+
+    hub->running.store(true);
+    for (std::unique_ptr<TrainerShard>& shard : hub->shards) {
+        shard->thread = std::thread(shardLoop, hub, shard.get());
+    }
+    return true;
+}
+
+static void wakeShard(TrainerShard* shard) {
+    {
+        std::lock_guard<std::mutex> guard(shard->wakeLock);
+        shard->notified = true;
+    }
+    shard->wake.notify_one();
+}
+
+void stopTrainerHub(TrainerHub* hub) {
+    if (!hub->running.exchange(false)) return;
+    for (std::unique_ptr<TrainerShard>& shard : hub->shards) {
+        wakeShard(shard.get());
+        shard->thread.join();
+    }
+}
+
+void notifyTrainer(TrainerHub* hub, int athlete, uint32_t events) {
+    if (athlete < 0 || athlete >= static_cast<int>(hub->trainers.size())) return;
+    TrainerContext* trainer = hub->trainers[athlete].get();
+    trainer->pendingEvents.fetch_or(events, std::memory_order_release);
+    wakeShard(hub->shards[trainer->shard].get());
+}
@@ -0,0 +1,166 @@
+/*
+ * Per-Athlete Trainer Context for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Everything one wearable needs between loop iterations: state machine,
+ * calibration, shot pipeline, sample rate and simulation RNG. A TrainerHub
+ * steps many contexts from a few shard threads (one per core), so a single
+ * host can serve a whole team; the stock trainer runs a hub of one.
+ *
+ * Shards block until a context is due or an event (IMU interrupt, button)
+ * arrives through notifyTrainer(). Each step says when it next needs to
+ * run: at the sample rate while sampling, or at the next timer on the
+ * context's wheel (periodic jobs, debounce, motor off-times) while idle
+ * in STANDBY, so an idle wearable wakes about once a second.
+ */
+
+#ifndef TRAINER_CONTEXT_H
+#define TRAINER_CONTEXT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "sensors.h"
+#include "haptic.h"
+#include "data_logger.h"
+#include "shot_analysis.h"
+#include "sim_random.h"
+#include "shot_generator.h"
+#include "rate_controller.h"
+#include "fir_decimator.h"
+#include "filter_pipeline.h"
+#include "hampel_filter.h"
+#include "spectral_features.h"
+#include "timer_wheel.h"
+#include "haptic_queue.h"
+
+// Hub Configuration
+const int MAX_ATHLETES = 64;
+const int SHOT_SEGMENT_CAPACITY = 8;  // Segments detectShots may find in one synthetic shot
+
+// Handler Intervals (ms)
+const unsigned long BUTTON_DEBOUNCE_INTERVAL = 50;
+const unsigned long STANDBY_BLINK_INTERVAL = 1000;
+const unsigned long SENSOR_PRINT_INTERVAL = 2000;
+const unsigned long BATTERY_CHECK_INTERVAL = 30000;
+
+// Simulated IMU wake-on-motion: bursts of arm movement at random intervals
+const unsigned long SIM_MOTION_INTERVAL = 5000;  // ms, mean gap between bursts
+const unsigned long SIM_MOTION_DURATION = 2000;  // ms
+
+// Events that wake a trainer between scheduled steps (bit flags)
+enum TrainerEvent : uint32_t {
+    TRAINER_EVENT_MOTION = 1,  // IMU motion or data-ready interrupt
+    TRAINER_EVENT_BUTTON = 2,  // Mode, shot or calibration button edge
+    TRAINER_EVENT_HAPTIC = 4   // Haptic command queued from another thread
+};
+
+// System States
+enum SystemState {
+    STANDBY,
+    CALIBRATION,
+    TRAINING,
+    DATA_REVIEW
+};
+
+// Running sums while the calibration shots are taken
+struct CalibrationProgress {
+    int shots;
+    double elbowSum, wristSum, timingSum;
+
+    CalibrationProgress() : shots(0), elbowSum(0), wristSum(0), timingSum(0) {}
+};
+
+struct TrainerContext {
+    int athlete;
+    SystemState currentState;
+    FreeThrowData currentShot;
+    FreeThrowCalibration formCalibration;
+    bool isCalibrated;
+    int shotCount;
+    unsigned long lastShotTime;
+    unsigned long holdUntil;  // Wheel ms; handlers pause (e.g. between calibration shots) without sleeping
+    CalibrationProgress calibration;
+    double lastAccel;         // m/s^2, for shot motion detection
+    MotionData lastMotionData;
+    PerformanceMetrics performanceMetrics;  // This session's shots, for the data review
+    LoggingMode loggingMode;  // Shots reach the shot log only with LOG_FILE_ONLY or LOG_BOTH
+    HapticMotorTable motors;
+    I2cBus buses[IMU_BUS_COUNT];  // Simulated controller per SDA/SCL pair; IMU_BUS_DRV has the drivers
+    Drv2605Array hapticDrivers;  // One per motor, for actuation latency
+    HapticQueue hapticQueue;  // Dispatched once per step
+    unsigned long simulatedMotionEnd;  // Wheel ms; end of the current simulated motion burst
+
+    // Every timed event: periodic jobs, debounce, motor off-times and
+    // pattern steps. Ticks are ms on the traceTimestampNs() clock.
+    TimerWheel timerWheel;
+    TimerId debounceTimer;
+
+    // Shot pipeline; buffers are reserved at init so a shot never allocates
+    SimRandom rng;
+    ShotGenerator shotGenerator;
+    RateController rateController;
+    FirDecimator shotDecimator;
+    MotionFilterPipeline shotFilters;
+    HampelFilter spikeFilter;
+    std::vector<MotionData> shotStreams[IMU_COUNT];
+    std::vector<MotionData> cleanedShot;
+    std::vector<MotionData> forearmShot;
+    std::vector<ShotSegment> shotSegments;
+    SlidingDft tremorDfts[IMU_COUNT];  // Gyro tremor band per IMU, run on every sample at SAMPLE_RATE
+    std::vector<double> forearmTremor;  // Forearm band power after each forearmShot sample
+    ShotData shotRecord;  // Handed to the shot log writer
+    bool shotRecordPending;  // shotRecord waits for its outcome
+
+    int shard;
+    uint64_t nextStepNs;  // Hub schedule, traceTimestampNs() clock
+    std::atomic<uint32_t> pendingEvents;
+
+    TrainerContext() : athlete(0), currentState(STANDBY), isCalibrated(false), shotCount(0),
+                       lastShotTime(0), holdUntil(0), lastAccel(0), loggingMode(LOG_FILE_ONLY),
+                       simulatedMotionEnd(0), debounceTimer(0), shotRecordPending(false), shard(0),
+                       nextStepNs(0), pendingEvents(0) {}
+};
+
+// Runs on the shard thread before a context's first step, e.g. to start
+// its periodic timers
+typedef void (*TrainerSetup)(TrainerContext* trainer);
+
+// One loop iteration for one athlete; events are the TrainerEvent bits
+// raised since the last step. Returns when to step next (traceTimestampNs).
+typedef uint64_t (*TrainerStep)(TrainerContext* trainer, uint32_t events);
+
+// A thread stepping its share of the contexts, each on its own schedule
+struct TrainerShard {
+    int index;
+    std::vector<TrainerContext*> trainers;
+    std::thread thread;
+    std::mutex wakeLock;
+    std::condition_variable wake;
+    bool notified;  // Guarded by wakeLock
+    std::atomic<uint64_t> steps;
+    std::atomic<uint64_t> wakeups;
+};
+
+struct TrainerHub {
+    std::vector<std::unique_ptr<TrainerContext>> trainers;
+    std::vector<std::unique_ptr<TrainerShard>> shards;
+    TrainerSetup setup;
+    TrainerStep step;
+    std::atomic<bool> running;
+
+    TrainerHub() : setup(nullptr), step(nullptr), running(false) {}
+};
+
+// Function Declarations
+void initTrainerContext(TrainerContext* trainer, int athlete, uint64_t seed);
+bool startTrainerHub(TrainerHub* hub, int athletes, TrainerSetup setup, TrainerStep step, uint64_t seed,
+                     unsigned shardCount = 0);  // 0: one shard per core, at most one per athlete
+void stopTrainerHub(TrainerHub* hub);
+void notifyTrainer(TrainerHub* hub, int athlete, uint32_t events);  // Safe from any thread
+
+#endif // TRAINER_CONTEXT_H
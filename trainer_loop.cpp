@@ -0,0 +1,480 @@
+/*
+ * Per-Athlete Trainer Loop for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "trainer_loop.h"
+#include "trace_log.h"
+#include "metrics.h"
+#include "span_trace.h"
+#include "alloc_tracker.h"
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+// Starts the periodic jobs and the simulated IMU on the trainer's wheel
+void setupTrainer(TrainerContext* trainer) {
+    TimerWheel* wheel = &trainer->timerWheel;
+    schedulePeriodicTimer(wheel, STANDBY_BLINK_INTERVAL, onStandbyBlink, trainer);
+    schedulePeriodicTimer(wheel, SENSOR_PRINT_INTERVAL, onSensorPrint, trainer);
+    schedulePeriodicTimer(wheel, BATTERY_CHECK_INTERVAL, onBatteryCheck, trainer);
+    scheduleTimer(wheel, simUniformInt(&trainer->rng, 2 * SIM_MOTION_INTERVAL), onMotionBurst, trainer);
+}
+
+// One hub step: the loop body plus sample rate bookkeeping. Returns when
+// the hub should step this athlete again if no event arrives first.
+uint64_t trainerStep(TrainerContext* trainer, uint32_t events) {
+    uint64_t loopStart = traceTimestampNs();
+    bindHapticMotors(&trainer->motors, &trainer->timerWheel);
+    for (I2cBus& bus : trainer->buses) {
+        runI2cBus(&bus, loopStart);  // Transactions held back since the last step
+    }
+    
+    // Steps that came later than one sample period dropped samples
+    if (isSampling(trainer) && loopStart >= trainer->nextStepNs) {
+        uint64_t missed = (loopStart - trainer->nextStepNs) / samplePeriodNs(&trainer->rateController);
+        if (missed > 0) {
+            incrementMetric(METRIC_LOOP_OVERRUNS);
+            incrementMetric(METRIC_SAMPLES_DROPPED, IMU_COUNT * missed);
+        }
+    }
+    
+    // Due timers run first; the simulated IMU raises its event from one
+    advanceTimerWheel(&trainer->timerWheel, loopStart / 1000000);
+    events |= trainer->pendingEvents.exchange(0, std::memory_order_acquire);
+    if (events & TRAINER_EVENT_MOTION) {
+        startCapture(&trainer->rateController, static_cast<unsigned long>(loopStart / 1000));
+    }
+    loop(trainer, events);
+    dispatchHapticQueue(&trainer->hapticQueue);
+    recordStageLatency(STAGE_LOOP, traceTimestampNs() - loopStart);
+    
+    updateSampleRate(&trainer->rateController, &trainer->lastMotionData, trainer->currentState == STANDBY);
+    if (trainer->athlete == 0) {
+        setGauge(GAUGE_SAMPLE_RATE, trainer->rateController.rate);  // Gauges follow the first athlete
+        setGauge(GAUGE_I2C_UTILIZATION, busiestI2cUtilization(trainer));
+    }
+    return nextStepTime(trainer, loopStart);
+}
+
+// Sampling steps keep the sample rate grid; otherwise sleep until the hold
+// ends. Either way wake no later than the next timer on the wheel.
+uint64_t nextStepTime(TrainerContext* trainer, uint64_t loopStart) {
+    uint64_t now = traceTimestampNs();
+    uint64_t next = UINT64_MAX;
+    
+    if (trainer->timerWheel.now < trainer->holdUntil) {
+        next = trainer->holdUntil * 1000000ULL;
+    } else if (isSampling(trainer)) {
+        uint64_t period = samplePeriodNs(&trainer->rateController);
+        uint64_t behind = loopStart > trainer->nextStepNs ? loopStart - trainer->nextStepNs : 0;
+        next = trainer->nextStepNs + (behind / period + 1) * period;
+        next = std::min(next, now + period);  // The rate may have just gone up
+    }
+    
+    uint64_t timerDue = nextTimerExpiry(&trainer->timerWheel);
+    if (timerDue != UINT64_MAX) {
+        next = std::min<uint64_t>(next, timerDue * 1000000);
+    }
+    return next;
+}
+
+// The gauge shows the bus closest to saturating
+int busiestI2cUtilization(const TrainerContext* trainer) {
+    int utilization = 0;
+    for (const I2cBus& bus : trainer->buses) {
+        utilization = std::max(utilization, bus.utilization);
+    }
+    return utilization;
+}
+
+// STANDBY between bursts needs no samples; every other state does
+bool isSampling(TrainerContext* trainer) {
+    return trainer->currentState != STANDBY || trainer->rateController.capturing;
+}
+
+// Timer Callbacks
+
+void onStandbyBlink(TimerWheel* wheel, void* context) {
+    (void)wheel;
+    TrainerContext* trainer = static_cast<TrainerContext*>(context);
+    
+    // Simulate slow blink LED
+    if (trainer->currentState == STANDBY) {
+        traceLog(TRACE_STATUS_STANDBY);
+    }
+}
+
+void onSensorPrint(TimerWheel* wheel, void* context) {
+    (void)wheel;
+    TrainerContext* trainer = static_cast<TrainerContext*>(context);
+    
+    if (trainer->currentState == STANDBY) {
+        printSensorData(trainer);
+    }
+}
+
+void onBatteryCheck(TimerWheel* wheel, void* context) {
+    (void)wheel;
+    monitorBattery(static_cast<TrainerContext*>(context));
+}
+
+void onButtonsSettled(TimerWheel* wheel, void* context) {
+    (void)wheel;
+    (void)context;
+    
+    // Simulate button presses for testing
+    // In real implementation, read the debounced GPIO pins
+}
+
+// Stands in for the IMU's wake-on-motion interrupt, which on hardware
+// would call notifyTrainer() from its ISR
+void onMotionBurst(TimerWheel* wheel, void* context) {
+    TrainerContext* trainer = static_cast<TrainerContext*>(context);
+    
+    trainer->simulatedMotionEnd = static_cast<unsigned long>(wheel->now) + SIM_MOTION_DURATION;
+    trainer->pendingEvents.fetch_or(TRAINER_EVENT_MOTION, std::memory_order_release);
+    scheduleTimer(wheel, SIM_MOTION_DURATION + simUniformInt(&trainer->rng, 2 * SIM_MOTION_INTERVAL),
+                  onMotionBurst, trainer);
+}
+
+void loop(TrainerContext* trainer, uint32_t events) {
+    ScopedSpan span("loop");
+    
+    // Check button states
+    checkButtons(trainer, events);
+    
+    // Update system based on current state, unless a handler asked to pause
+    if (trainer->athlete == 0) {
+        setGauge(GAUGE_SYSTEM_STATE, trainer->currentState);
+    }
+    setAllocationState(trainer->currentState);
+    if (trainer->timerWheel.now >= trainer->holdUntil) {
+        switch (trainer->currentState) {
+            case STANDBY:
+                handleStandby(trainer);
+                break;
+            case CALIBRATION:
+                handleCalibration(trainer);
+                break;
+            case TRAINING:
+                handleTraining(trainer);
+                break;
+            case DATA_REVIEW:
+                handleDataReview(trainer);
+                break;
+        }
+    }
+}
+
+void checkButtons(TrainerContext* trainer, uint32_t events) {
+    if (!(events & TRAINER_EVENT_BUTTON)) return;  // Buttons raise an edge interrupt
+    
+    // Debounce: read the pins once the edges have settled
+    if (!timerPending(&trainer->timerWheel, trainer->debounceTimer)) {
+        trainer->debounceTimer = scheduleTimer(&trainer->timerWheel, BUTTON_DEBOUNCE_INTERVAL,
+                                               onButtonsSettled, trainer);
+    }
+}
+
+void handleStandby(TrainerContext* trainer) {
+    ScopedSpan span("handleStandby");
+    
+    // Read sensors from the motion interrupt until the arm goes still again;
+    // the status LED and sensor printout run from timers
+    if (trainer->rateController.capturing) {
+        readAllSensors(trainer);
+    }
+}
+
+void handleCalibration(TrainerContext* trainer) {
+    ScopedSpan span("handleCalibration");
+    traceLog(TRACE_CALIBRATION_MODE);
+    
+    CalibrationProgress& progress = trainer->calibration;
+    
+    if (detectShotMotion(trainer)) {
+        incrementMetric(METRIC_SHOTS_DETECTED);
+        progress.shots++;
+        
+        // Collect data for this shot
+        FreeThrowData shotData = analyzeShotForm(trainer);
+        progress.elbowSum += shotData.elbowAngle;
+        progress.wristSum += shotData.wristAngle;
+        progress.timingSum += shotData.releaseTiming;
+        
+        traceLog(TRACE_CALIBRATION_SHOT, progress.shots);
+        
+        // Provide haptic feedback
+        queueHapticPulse(&trainer->hapticQueue, HAPTIC_PRIORITY_CONFIRMATION, HAPTIC_1_PIN, STRONG, 100);
+        
+        if (progress.shots >= 10) {
+            // Calculate averages
+            FreeThrowCalibration& calibration = trainer->formCalibration;
+            calibration.avgElbowAngle = progress.elbowSum / 10.0;
+            calibration.avgWristAngle = progress.wristSum / 10.0;
+            calibration.avgReleaseTiming = progress.timingSum / 10.0;
+            calibration.isValid = true;
+            trainer->isCalibrated = true;
+            
+            traceLog(TRACE_CALIBRATION_COMPLETE, calibration.avgElbowAngle);
+            
+            trainer->currentState = STANDBY;
+            progress = CalibrationProgress();
+        }
+        
+        trainer->holdUntil = trainer->timerWheel.now + 2000;  // Wait between shots
+    }
+}
+
+void handleTraining(TrainerContext* trainer) {
+    ScopedSpan span("handleTraining");
+    AllocationGuard guard("handleTraining");
+    
+    if (!trainer->isCalibrated) {
+        traceLog(TRACE_CALIBRATION_REQUIRED);
+        trainer->currentState = STANDBY;
+        return;
+    }
+    
+    if (detectShotMotion(trainer)) {
+        incrementMetric(METRIC_SHOTS_DETECTED);
+        trainer->currentShot = analyzeShotForm(trainer);
+        provideHapticFeedback(trainer, trainer->currentShot);
+        
+        trainer->shotCount++;
+        trainer->lastShotTime = millis();
+        logShot(trainer);
+        
+        traceLog(TRACE_SHOT_ANALYZED);
+    }
+}
+
+void handleDataReview(TrainerContext* trainer) {
+    ScopedSpan span("handleDataReview");
+    const PerformanceMetrics& metrics = trainer->performanceMetrics;
+    traceLog(TRACE_DATA_REVIEW, metrics.totalShots, metrics.averageScore, 100.0 * metrics.accuracyRate);
+    
+    if (trainer->isCalibrated) {
+        traceLog(TRACE_DATA_REVIEW_CALIBRATION, trainer->formCalibration.avgElbowAngle);
+    }
+    
+    // Show the review for 5 seconds, then return to standby
+    trainer->holdUntil = trainer->timerWheel.now + 5000;
+    trainer->currentState = STANDBY;
+}
+
+bool detectShotMotion(TrainerContext* trainer) {
+    // Simulate motion detection
+    // In real implementation, read from BNO055
+    readAllSensors(trainer);
+    double currentAccel = trainer->lastMotionData.magnitude * GRAVITY;
+    
+    bool motionDetected = std::abs(currentAccel - trainer->lastAccel) > 5.0;
+    trainer->lastAccel = currentAccel;
+    
+    return motionDetected;
+}
+
+FreeThrowData analyzeShotForm(TrainerContext* trainer) {
+    ScopedSpan span("analyzeShotForm");
+    ScopedStageTimer timer(STAGE_SHOT_ANALYSIS);
+    
+    // Synthesize one shot at the capture rate, reject glitches, decimate it
+    // to SAMPLE_RATE, filter it and run it through the real detection and
+    // analysis
+    for (int imu = 0; imu < IMU_COUNT; imu++) {
+        trainer->shotStreams[imu].clear();
+    }
+    trainer->cleanedShot.clear();
+    trainer->forearmShot.clear();
+    FreeThrowData expected;
+    generateShot(&trainer->shotGenerator, trainer->shotStreams, &expected);
+    
+    MotionData sample;
+    for (const MotionData& raw : trainer->shotStreams[SHOT_IMU_FOREARM]) {
+        if (hampelFilterSample(&trainer->spikeFilter, &raw, &sample)) trainer->cleanedShot.push_back(sample);
+    }
+    while (hampelFilterFlush(&trainer->spikeFilter, &sample)) {
+        trainer->cleanedShot.push_back(sample);
+    }
+    decimateBlock(&trainer->shotDecimator, trainer->cleanedShot.data(), trainer->cleanedShot.size(),
+                  &trainer->forearmShot);
+    std::vector<MotionData>& forearm = trainer->forearmShot;
+    trainer->shotFilters.processBlock(forearm.data(), forearm.size());
+    updateTremorBands(trainer);
+    if (detectShots(forearm, &trainer->shotSegments) == 0) {
+        return expected;
+    }
+    const ShotSegment& shot = trainer->shotSegments.back();
+    return analyzeShotForm(&forearm[shot.start], shot.end - shot.start, &trainer->forearmTremor[shot.start]);
+}
+
+// Runs every IMU's tremor DFT over the new samples at SAMPLE_RATE: the
+// forearm on its decimated stream, noting the band power at each sample;
+// the others on every ratio-th capture sample
+void updateTremorBands(TrainerContext* trainer) {
+    ScopedSpan span("updateTremorBands");
+    size_t ratio = trainer->shotDecimator.ratio;
+    for (int imu = 0; imu < IMU_COUNT; imu++) {
+        if (imu == SHOT_IMU_FOREARM) continue;
+        const std::vector<MotionData>& stream = trainer->shotStreams[imu];
+        for (size_t i = 0; i < stream.size(); i += ratio) {
+            slidingDftUpdate(&trainer->tremorDfts[imu], stream[i].gyro);
+        }
+    }
+    
+    SlidingDft* forearmDft = &trainer->tremorDfts[SHOT_IMU_FOREARM];
+    trainer->forearmTremor.clear();
+    for (const MotionData& sample : trainer->forearmShot) {
+        slidingDftUpdate(forearmDft, sample.gyro);
+        trainer->forearmTremor.push_back(slidingDftBandPower(forearmDft));
+    }
+}
+
+void provideHapticFeedback(TrainerContext* trainer, const FreeThrowData& shotData) {
+    ScopedSpan span("provideHapticFeedback");
+    ScopedStageTimer timer(STAGE_HAPTIC_FEEDBACK);
+    HapticQueue* queue = &trainer->hapticQueue;
+    
+    // Compare with calibration data
+    double elbowError = std::abs(shotData.elbowAngle - trainer->formCalibration.avgElbowAngle);
+    double wristError = std::abs(shotData.wristAngle - trainer->formCalibration.avgWristAngle);
+    
+    // Provide feedback based on errors; a loaded cue replaces the built-in one
+    if (elbowError > ELBOW_ANGLE_TOLERANCE) {
+        const HapticSequence* cue = hapticCue(HAPTIC_CUE_ELBOW_CORRECTION);
+        if (cue) {
+            queueHapticSequence(queue, HAPTIC_PRIORITY_CORRECTION, ALL_ZONES, cue, STRONG);
+        } else {
+            queueHapticPulse(queue, HAPTIC_PRIORITY_CORRECTION, HAPTIC_1_PIN, STRONG, 300);
+        }
+        traceLog(TRACE_HAPTIC_ELBOW);
+    } else if (wristError > WRIST_ANGLE_TOLERANCE) {
+        const HapticSequence* cue = hapticCue(HAPTIC_CUE_WRIST_CORRECTION);
+        if (cue) {
+            queueHapticSequence(queue, HAPTIC_PRIORITY_CORRECTION, ALL_ZONES, cue, MEDIUM);
+        } else {
+            queueHapticPulse(queue, HAPTIC_PRIORITY_CORRECTION, HAPTIC_3_PIN, MEDIUM, 150);
+        }
+        traceLog(TRACE_HAPTIC_WRIST);
+    } else {
+        const HapticSequence* cue = hapticCue(HAPTIC_CUE_GOOD_FORM);
+        if (cue) {
+            queueHapticSequence(queue, HAPTIC_PRIORITY_CONFIRMATION, ALL_ZONES, cue, LIGHT);
+        } else {
+            queueHapticPattern(queue, HAPTIC_PRIORITY_CONFIRMATION, ALL_ZONES, DOUBLE_PULSE, LIGHT);
+        }
+        traceLog(TRACE_HAPTIC_GOOD_FORM);
+    }
+}
+
+// Builds the current shot's record and holds it until its outcome is
+// known; the forearm path comes from the segment analyzeShotForm() used
+void logShot(TrainerContext* trainer) {
+    flushShotRecord(trainer);  // No outcome came for the previous shot: a miss
+    
+    ShotData* record = &trainer->shotRecord;
+    const MotionData* samples = nullptr;
+    size_t count = 0;
+    if (!trainer->shotSegments.empty()) {
+        const ShotSegment& shot = trainer->shotSegments.back();
+        samples = &trainer->forearmShot[shot.start];
+        count = shot.end - shot.start;
+    }
+    
+    record->timestamp = trainer->lastShotTime;
+    double score = scoreShotForm(trainer->currentShot, trainer->formCalibration);
+    buildShotRecord(samples, count, trainer->currentShot, score, record);
+    trainer->shotRecordPending = true;
+    
+    // Running totals for the review; the shot counts as missed until marked made
+    PerformanceMetrics& metrics = trainer->performanceMetrics;
+    metrics.totalShots++;
+    metrics.averageScore += (score - metrics.averageScore) / metrics.totalShots;
+    metrics.bestScore = std::max(metrics.bestScore, score);
+    metrics.accuracyRate *= (metrics.totalShots - 1) / static_cast<double>(metrics.totalShots);
+}
+
+// Hands the held shot record, if any, to the shot log writer when the
+// athlete's logging mode includes the file
+void flushShotRecord(TrainerContext* trainer) {
+    if (!trainer->shotRecordPending) return;
+    trainer->shotRecordPending = false;
+    if (trainer->loggingMode != LOG_FILE_ONLY && trainer->loggingMode != LOG_BOTH) return;
+    if (!queueShotForLogging(&trainer->shotRecord)) {
+        traceLog(TRACE_SHOT_LOG_FULL);
+    }
+}
+
+void readAllSensors(TrainerContext* trainer) {
+    ScopedSpan span("readAllSensors");
+    ScopedStageTimer timer(STAGE_SENSOR_READ);
+    queueImuReads(trainer->buses);
+    
+    // The bursts are timed on the simulated bus; the values are synthesized
+    trainer->lastMotionData.timestamp = static_cast<unsigned long>(traceTimestampNs() / 1000);
+    if (trainer->timerWheel.now < trainer->simulatedMotionEnd) {
+        trainer->lastMotionData.magnitude = simUniformInt(&trainer->rng, 100) / 10.0 / GRAVITY;
+    } else {
+        trainer->lastMotionData.magnitude = 0;
+    }
+}
+
+void printSensorData(TrainerContext* trainer) {
+    // Simulate sensor data output
+    SimRandom* rng = &trainer->rng;
+    traceLog(TRACE_SENSOR_BNO055, simUniformInt(rng, 360), simUniformInt(rng, 360), simUniformInt(rng, 360));
+    traceLog(TRACE_SENSOR_MPU6050, simUniformInt(rng, 1000), simUniformInt(rng, 1000), simUniformInt(rng, 1000));
+}
+
+void cycleSystemState(TrainerContext* trainer) {
+    switch (trainer->currentState) {
+        case STANDBY:
+            trainer->currentState = TRAINING;
+            traceLog(TRACE_STATE_TRAINING);
+            break;
+        case TRAINING:
+            flushShotRecord(trainer);
+            trainer->currentState = DATA_REVIEW;
+            traceLog(TRACE_STATE_DATA_REVIEW);
+            break;
+        case DATA_REVIEW:
+            trainer->currentState = STANDBY;
+            traceLog(TRACE_STATE_STANDBY);
+            break;
+        case CALIBRATION:
+            // Can't switch out of calibration mode
+            break;
+    }
+}
+
+// The shot button marks the last shot made, which logs it
+void recordShotOutcome(TrainerContext* trainer) {
+    traceLog(TRACE_SHOT_OUTCOME);
+    if (trainer->shotRecordPending) {
+        trainer->shotRecord.wasSuccessful = true;
+        trainer->performanceMetrics.accuracyRate += 1.0 / trainer->performanceMetrics.totalShots;
+        flushShotRecord(trainer);
+    }
+    queueHapticPulse(&trainer->hapticQueue, HAPTIC_PRIORITY_CONFIRMATION, HAPTIC_2_PIN, LIGHT, 100);
+}
+
+// Every BATTERY_CHECK_INTERVAL, from onBatteryCheck
+void monitorBattery(TrainerContext* trainer) {
+    double voltage = 3.7 + simUniformInt(&trainer->rng, 10) / 100.0;  // Simulate battery voltage
+    
+    traceLog(TRACE_BATTERY_VOLTAGE, voltage);
+    
+    if (voltage < 3.2) {
+        traceLog(TRACE_BATTERY_LOW);
+    }
+}
+
+// Utility function to simulate Arduino millis()
+unsigned long millis() {
+    static auto start = std::chrono::steady_clock::now();
+    auto now = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - start);
+    return duration.count();
+}
@@ -0,0 +1,46 @@
+/*
+ * Per-Athlete Trainer Loop for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * The state machine and shot pipeline that one hub step runs for one
+ * athlete. The trainer hands setupTrainer and trainerStep to its hub; the
+ * allocation check drives them directly.
+ */
+
+#ifndef TRAINER_LOOP_H
+#define TRAINER_LOOP_H
+
+#include <cstdint>
+#include "trainer_context.h"
+
+// Function Declarations
+void setupTrainer(TrainerContext* trainer);
+uint64_t trainerStep(TrainerContext* trainer, uint32_t events);
+uint64_t nextStepTime(TrainerContext* trainer, uint64_t loopStart);
+bool isSampling(TrainerContext* trainer);
+int busiestI2cUtilization(const TrainerContext* trainer);
+void onStandbyBlink(TimerWheel* wheel, void* context);
+void onSensorPrint(TimerWheel* wheel, void* context);
+void onBatteryCheck(TimerWheel* wheel, void* context);
+void onButtonsSettled(TimerWheel* wheel, void* context);
+void onMotionBurst(TimerWheel* wheel, void* context);
+void loop(TrainerContext* trainer, uint32_t events);
+void checkButtons(TrainerContext* trainer, uint32_t events);
+void handleStandby(TrainerContext* trainer);
+void handleCalibration(TrainerContext* trainer);
+void handleTraining(TrainerContext* trainer);
+void handleDataReview(TrainerContext* trainer);
+bool detectShotMotion(TrainerContext* trainer);
+FreeThrowData analyzeShotForm(TrainerContext* trainer);
+void updateTremorBands(TrainerContext* trainer);
+void provideHapticFeedback(TrainerContext* trainer, const FreeThrowData& shotData);
+void logShot(TrainerContext* trainer);
+void flushShotRecord(TrainerContext* trainer);
+void readAllSensors(TrainerContext* trainer);
+void printSensorData(TrainerContext* trainer);
+void cycleSystemState(TrainerContext* trainer);
+void recordShotOutcome(TrainerContext* trainer);
+void monitorBattery(TrainerContext* trainer);
+unsigned long millis();
+
+#endif // TRAINER_LOOP_H
@@ -0,0 +1,114 @@
+/*
+ * Training Allocation Check for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Drives one TrainerContext through generated shots in TRAINING, the way
+ * a hub shard steps it, and fails unless the allocation tracker counted
+ * no allocation while the state was TRAINING. Built with
+ * -DTRACK_ALLOCATIONS by `make check`; without the tracker it fails too.
+ *
+ * Usage: training_alloc_check [shots]
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include "alloc_tracker.h"
+#include "data_logger.h"
+#include "haptic.h"
+#include "shot_analysis.h"
+#include "sim_random.h"
+#include "span_trace.h"
+#include "trace_log.h"
+#include "trainer_context.h"
+#include "trainer_loop.h"
+
+const int DEFAULT_CHECK_SHOTS = 50;
+const uint64_t MAX_CHECK_STEPS = 1000000;  // Gives up if the shots never come
+
+int main(int argc, char* argv[]) {
+    int shots = argc > 1 ? std::atoi(argv[1]) : DEFAULT_CHECK_SHOTS;
+    if (shots < 1) {
+        std::cerr << "Usage: training_alloc_check [shots]" << std::endl;
+        return 1;
+    }
+    if (!allocationTrackingEnabled()) {
+        std::cerr << "FAIL: built without TRACK_ALLOCATIONS, nothing was counted" << std::endl;
+        return 1;
+    }
+
+    // The shot log goes to a scratch directory, not the athlete's; cues
+    // still come from where the check was started
+    std::error_code error;
+    std::filesystem::path cues = std::filesystem::absolute(HAPTIC_CUE_DIRECTORY, error);
+    std::filesystem::path scratch = std::filesystem::temp_directory_path(error) / "training_alloc_check";
+    std::filesystem::remove_all(scratch, error);
+    std::filesystem::create_directories(scratch, error);
+    std::filesystem::current_path(scratch, error);
+    if (error) {
+        std::cerr << "Cannot use " << scratch << ": " << error.message() << std::endl;
+        return 1;
+    }
+
+    // Same start-up as the trainer's setup(), counting instead of aborting
+    // so every allocation shows up in the result
+    initSensors();
+    initHapticSystem();
+    loadHapticCues(cues.string());
+    initDataLogger();
+    setSimulationSeed(SIM_DEFAULT_SEED);
+    setAllocationPolicy(ALLOC_POLICY_COUNT);
+    startTraceLogger();
+
+    // Set up on this thread as a shard would, then calibrate from
+    // generated shots so TRAINING has a reference to score against
+    std::unique_ptr<TrainerContext> trainer(new TrainerContext());
+    initTrainerContext(trainer.get(), 0, SIM_DEFAULT_SEED);
+    setSpanThreadName("trainer_shard");
+    attachTraceThread();
+    setSimulationStream(simStream(SIM_STREAM_SHARD, 0));
+    setupTrainer(trainer.get());
+
+    std::vector<FreeThrowData> calibrationShots;
+    for (int i = 0; i < CALIBRATION_SAMPLES; i++) {
+        calibrationShots.push_back(analyzeShotForm(trainer.get()));
+    }
+    calibrateFromShots(calibrationShots.data(), calibrationShots.size(), &trainer->formCalibration);
+    trainer->isCalibrated = true;
+
+    // Keep the simulated arm moving so every step can detect a shot, and
+    // mark every other shot made as the shot button would
+    trainer->currentState = TRAINING;
+    trainer->simulatedMotionEnd = static_cast<unsigned long>(-1);
+    uint64_t steps = 0;
+    while (trainer->shotCount < shots && steps < MAX_CHECK_STEPS) {
+        int shotsBefore = trainer->shotCount;
+        trainerStep(trainer.get(), 0);
+        if (trainer->shotCount > shotsBefore && trainer->shotCount % 2 == 0) {
+            recordShotOutcome(trainer.get());
+        }
+        steps++;
+    }
+    flushShotRecord(trainer.get());
+    setAllocationState(STANDBY);
+
+    AllocationCounts training = stateAllocationCounts(TRAINING);
+    stopDataLogger();
+    stopTraceLogger();
+
+    std::cout << trainer->shotCount << " shots in " << steps << " TRAINING steps: " << training.allocations
+              << " allocations (" << training.bytes << " bytes), " << training.critical << " in guarded sections"
+              << std::endl;
+    if (trainer->shotCount < shots) {
+        std::cerr << "FAIL: only " << trainer->shotCount << " of " << shots << " shots were detected" << std::endl;
+        return 1;
+    }
+    if (training.allocations != 0) {
+        std::cerr << "FAIL: the TRAINING path allocated" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS: zero allocations per shot" << std::endl;
+    return 0;
+}
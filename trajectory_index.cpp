@@ -0,0 +1,152 @@
+/*
+ * Trajectory Library Index for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "trajectory_index.h"
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+// Candidate set during a search: max-heap on distance
+typedef std::priority_queue<std::pair<double, int>> CandidateHeap;
+
+static double recordDistance(const TrajectoryIndex* index, const QuantizedTrajectory& query, int record) {
+    return quantizedTrajectoryRmsDistance(query, index->records[record].trajectory);
+}
+
+// Turns an overfull leaf into a vantage node with two leaf children. Ties
+// with the radius go inside; if every record is as far from the vantage
+// as the farthest (duplicates), no radius separates them and the leaf
+// stays whole until it doubles.
+static void splitLeaf(TrajectoryIndex* index, int nodeIndex) {
+    std::vector<int> bucket = index->nodes[nodeIndex].bucket;
+    int vantage = bucket.back();
+    bucket.pop_back();
+
+    const QuantizedTrajectory& vantageTrajectory = index->records[vantage].trajectory;
+    std::vector<std::pair<double, int>> byDistance;
+    byDistance.reserve(bucket.size());
+    for (int record : bucket) {
+        byDistance.push_back(std::make_pair(recordDistance(index, vantageTrajectory, record), record));
+    }
+    std::sort(byDistance.begin(), byDistance.end());
+
+    // The median, or failing that the largest distance below the farthest
+    double farthest = byDistance.back().first;
+    double radius = byDistance[byDistance.size() / 2].first;
+    if (radius >= farthest) {
+        auto below = std::lower_bound(byDistance.begin(), byDistance.end(), std::make_pair(farthest, -1));
+        if (below == byDistance.begin()) {
+            index->nodes[nodeIndex].splitSize *= 2;
+            return;
+        }
+        radius = (below - 1)->first;
+    }
+
+    int inside = static_cast<int>(index->nodes.size());
+    index->nodes.resize(index->nodes.size() + 2);
+    TrajectoryIndexNode& node = index->nodes[nodeIndex];
+    node.vantage = vantage;
+    node.radius = radius;
+    node.inside = inside;
+    node.outside = inside + 1;
+    node.bucket.clear();
+    node.bucket.shrink_to_fit();
+
+    for (const std::pair<double, int>& entry : byDistance) {
+        int child = entry.first <= radius ? node.inside : node.outside;
+        index->nodes[child].bucket.push_back(entry.second);
+    }
+}
+
+bool insertTrajectory(TrajectoryIndex* index, const TrajectoryRecord& record) {
+    size_t points = record.trajectory.size();
+    if (points == 0 || (index->points != 0 && points != index->points)) return false;
+    index->points = points;
+
+    int recordIndex = static_cast<int>(index->records.size());
+    index->records.push_back(record);
+
+    // Descend to the leaf this record falls into
+    int nodeIndex = 0;
+    while (index->nodes[nodeIndex].vantage >= 0) {
+        const TrajectoryIndexNode& node = index->nodes[nodeIndex];
+        double distance = recordDistance(index, record.trajectory, node.vantage);
+        nodeIndex = distance <= node.radius ? node.inside : node.outside;
+    }
+
+    TrajectoryIndexNode& leaf = index->nodes[nodeIndex];
+    leaf.bucket.push_back(recordIndex);
+    if (leaf.bucket.size() > leaf.splitSize) {
+        splitLeaf(index, nodeIndex);
+    }
+    return true;
+}
+
+static void offerCandidate(const TrajectoryIndex* index, int record, double distance, size_t count,
+                           bool successfulOnly, CandidateHeap* heap) {
+    if (successfulOnly && !index->records[record].wasSuccessful) return;
+    if (heap->size() < count) {
+        heap->push(std::make_pair(distance, record));
+    } else if (distance < heap->top().first) {
+        heap->pop();
+        heap->push(std::make_pair(distance, record));
+    }
+}
+
+static void searchNode(const TrajectoryIndex* index, int nodeIndex, const QuantizedTrajectory& query, size_t count,
+                       bool successfulOnly, CandidateHeap* heap) {
+    const TrajectoryIndexNode& node = index->nodes[nodeIndex];
+    if (node.vantage < 0) {
+        for (int record : node.bucket) {
+            offerCandidate(index, record, recordDistance(index, query, record), count, successfulOnly, heap);
+        }
+        return;
+    }
+
+    double distance = recordDistance(index, query, node.vantage);
+    offerCandidate(index, node.vantage, distance, count, successfulOnly, heap);
+
+    // Visit the likelier side first; the other side only if the current
+    // search radius still reaches across the boundary
+    bool insideFirst = distance <= node.radius;
+    int first = insideFirst ? node.inside : node.outside;
+    int second = insideFirst ? node.outside : node.inside;
+
+    searchNode(index, first, query, count, successfulOnly, heap);
+
+    double tau = heap->size() < count ? std::numeric_limits<double>::infinity() : heap->top().first;
+    bool reachesOther = insideFirst ? distance + tau >= node.radius : distance - tau <= node.radius;
+    if (reachesOther) {
+        searchNode(index, second, query, count, successfulOnly, heap);
+    }
+}
+
+// Similarity is 1 / (1 + distance), so the k nearest are the k most similar
+size_t findSimilarTrajectories(const TrajectoryIndex* index, const std::vector<Vector3D>& query,
+                               size_t k, std::vector<TrajectoryMatch>* matches,
+                               bool successfulOnly) {
+    matches->clear();
+    if (k == 0 || index->records.empty() || query.size() != index->points) return 0;
+
+    QuantizedTrajectory quantizedQuery;
+    quantizeTrajectory(query, &quantizedQuery);
+    CandidateHeap heap;
+    searchNode(index, 0, quantizedQuery, k, successfulOnly, &heap);
+
+    matches->resize(heap.size());
+    for (size_t i = heap.size(); i-- > 0; heap.pop()) {
+        const TrajectoryRecord& record = index->records[heap.top().second];
+        TrajectoryMatch& match = (*matches)[i];
+        match.shotId = record.shotId;
+        match.timestamp = record.timestamp;
+        match.wasSuccessful = record.wasSuccessful;
+        match.similarity = 1.0 / (1.0 + heap.top().first);
+    }
+    return matches->size();
+}
+
+size_t trajectoryIndexSize(const TrajectoryIndex* index) {
+    return index->records.size();
+}
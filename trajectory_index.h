@@ -0,0 +1,68 @@
+/*
+ * Trajectory Library Index for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Vantage-point tree over the stored quantized trajectories, searched with
+ * the distance calculateTrajectorySimilarity is built on (RMS distance of
+ * index-aligned points), so matches rank exactly as the similarity would.
+ * That distance is only a metric between trajectories of one length, so
+ * an index holds a single length: the first record sets it.
+ */
+
+#ifndef TRAJECTORY_INDEX_H
+#define TRAJECTORY_INDEX_H
+
+#include <vector>
+#include "sensors.h"
+#include "trajectory_quant.h"
+
+// Index Configuration
+const size_t TRAJECTORY_LEAF_SIZE = 16;  // Leaf bucket size before a split
+
+// A stored shot in the library
+struct TrajectoryRecord {
+    unsigned long shotId;
+    unsigned long timestamp;
+    bool wasSuccessful;
+    QuantizedTrajectory trajectory;
+
+    TrajectoryRecord() : shotId(0), timestamp(0), wasSuccessful(false) {}
+};
+
+struct TrajectoryMatch {
+    unsigned long shotId;
+    unsigned long timestamp;
+    bool wasSuccessful;
+    double similarity;
+
+    TrajectoryMatch() : shotId(0), timestamp(0), wasSuccessful(false), similarity(0) {}
+};
+
+// Vantage-point tree node; leaves hold a bucket, inner nodes a vantage record
+struct TrajectoryIndexNode {
+    int vantage;        // Record index, -1 for leaves
+    double radius;      // Records this close or closer go inside
+    int inside;
+    int outside;
+    size_t splitSize;   // Leaves: bucket size that triggers the next split
+    std::vector<int> bucket;
+
+    TrajectoryIndexNode() : vantage(-1), radius(0), inside(-1), outside(-1), splitSize(TRAJECTORY_LEAF_SIZE) {}
+};
+
+struct TrajectoryIndex {
+    std::vector<TrajectoryRecord> records;
+    std::vector<TrajectoryIndexNode> nodes;
+    size_t points;  // Trajectory length of every record, 0 while empty
+
+    TrajectoryIndex() : points(0) { nodes.resize(1); }
+};
+
+// Function Declarations
+bool insertTrajectory(TrajectoryIndex* index, const TrajectoryRecord& record);  // False for another length
+size_t findSimilarTrajectories(const TrajectoryIndex* index, const std::vector<Vector3D>& query,
+                               size_t k, std::vector<TrajectoryMatch>* matches,
+                               bool successfulOnly = false);
+size_t trajectoryIndexSize(const TrajectoryIndex* index);
+
+#endif // TRAJECTORY_INDEX_H
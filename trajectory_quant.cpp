@@ -0,0 +1,186 @@
+/*
+ * Quantized Trajectory Encoding for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ */
+
+#include "trajectory_quant.h"
+#include "log_block.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Offset and scale are kept at float precision so a disk round trip is exact
+const size_t QUANT_HEADER_BYTES = 6 * 4 + 2;
+
+// Integer sums for one axis, enough to expand sum((o1 + s1*a - o2 - s2*b)^2)
+struct AxisSums {
+    int64_t aa, bb, ab, a, b;
+
+    AxisSums() : aa(0), bb(0), ab(0), a(0), b(0) {}
+};
+
+static void quantizeAxis(const std::vector<Vector3D>& trajectory, double Vector3D::*axis,
+                         double* offset, double* scale, std::vector<int16_t>* out) {
+    double lo = 0, hi = 0;
+    if (!trajectory.empty()) {
+        lo = hi = trajectory[0].*axis;
+    }
+    for (const Vector3D& point : trajectory) {
+        lo = std::min(lo, point.*axis);
+        hi = std::max(hi, point.*axis);
+    }
+
+    *offset = static_cast<float>((lo + hi) / 2.0);
+    *scale = static_cast<float>((hi - lo) / (2.0 * TRAJECTORY_QUANT_MAX));
+    if (*scale <= 0) *scale = 1.0;  // Flat axis: every point sits on the offset
+    // Float rounding of the scale can push the extremes just past the range
+    if ((hi - *offset) / *scale > TRAJECTORY_QUANT_MAX || (*offset - lo) / *scale > TRAJECTORY_QUANT_MAX) {
+        *scale = std::nextafter(static_cast<float>(*scale), 1e30f);
+    }
+
+    out->resize(trajectory.size());
+    for (size_t i = 0; i < trajectory.size(); i++) {
+        long q = std::lround((trajectory[i].*axis - *offset) / *scale);
+        if (q > TRAJECTORY_QUANT_MAX) q = TRAJECTORY_QUANT_MAX;
+        if (q < -TRAJECTORY_QUANT_MAX) q = -TRAJECTORY_QUANT_MAX;
+        (*out)[i] = static_cast<int16_t>(q);
+    }
+}
+
+void quantizeTrajectory(const std::vector<Vector3D>& trajectory, QuantizedTrajectory* out) {
+    quantizeAxis(trajectory, &Vector3D::x, &out->offset.x, &out->scale.x, &out->x);
+    quantizeAxis(trajectory, &Vector3D::y, &out->offset.y, &out->scale.y, &out->y);
+    quantizeAxis(trajectory, &Vector3D::z, &out->offset.z, &out->scale.z, &out->z);
+}
+
+void dequantizeTrajectory(const QuantizedTrajectory& quantized, std::vector<Vector3D>* out) {
+    out->resize(quantized.size());
+    for (size_t i = 0; i < quantized.size(); i++) {
+        (*out)[i] = Vector3D(quantized.offset.x + quantized.scale.x * quantized.x[i],
+                             quantized.offset.y + quantized.scale.y * quantized.y[i],
+                             quantized.offset.z + quantized.scale.z * quantized.z[i]);
+    }
+}
+
+// Serialization
+
+size_t quantizedTrajectoryBytes(size_t points) {
+    return QUANT_HEADER_BYTES + points * 6;
+}
+
+void serializeQuantizedTrajectory(const QuantizedTrajectory& quantized, std::vector<uint8_t>* out) {
+    putFloat(out, quantized.offset.x);
+    putFloat(out, quantized.offset.y);
+    putFloat(out, quantized.offset.z);
+    putFloat(out, quantized.scale.x);
+    putFloat(out, quantized.scale.y);
+    putFloat(out, quantized.scale.z);
+    putU16(out, static_cast<uint16_t>(quantized.size()));
+
+    const std::vector<int16_t>* axes[3] = {&quantized.x, &quantized.y, &quantized.z};
+    for (const std::vector<int16_t>* axis : axes) {
+        for (int16_t value : *axis) {
+            putU16(out, static_cast<uint16_t>(value));
+        }
+    }
+}
+
+bool deserializeQuantizedTrajectory(const uint8_t* data, size_t length, QuantizedTrajectory* out) {
+    if (length < QUANT_HEADER_BYTES) return false;
+
+    out->offset = Vector3D(getFloat(data), getFloat(data + 4), getFloat(data + 8));
+    out->scale = Vector3D(getFloat(data + 12), getFloat(data + 16), getFloat(data + 20));
+    size_t points = getU16(data + 24);
+    if (length != quantizedTrajectoryBytes(points)) return false;
+
+    const uint8_t* in = data + QUANT_HEADER_BYTES;
+    std::vector<int16_t>* axes[3] = {&out->x, &out->y, &out->z};
+    for (std::vector<int16_t>* axis : axes) {
+        axis->resize(points);
+        for (size_t i = 0; i < points; i++, in += 2) {
+            (*axis)[i] = static_cast<int16_t>(getU16(in));
+        }
+    }
+    return true;
+}
+
+// Matching
+
+static void accumulateAxis(const int16_t* a, const int16_t* b, size_t n, AxisSums* sums) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    // Each madd lane gains at most 2 * 8191^2 per step, so 16 steps fit in int32
+    const __m128i ones = _mm_set1_epi16(1);
+    while (i + 8 <= n) {
+        __m128i aa = _mm_setzero_si128(), bb = aa, ab = aa, sa = aa, sb = aa;
+        for (int step = 0; step < 16 && i + 8 <= n; step++, i += 8) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            aa = _mm_add_epi32(aa, _mm_madd_epi16(va, va));
+            bb = _mm_add_epi32(bb, _mm_madd_epi16(vb, vb));
+            ab = _mm_add_epi32(ab, _mm_madd_epi16(va, vb));
+            sa = _mm_add_epi32(sa, _mm_madd_epi16(va, ones));
+            sb = _mm_add_epi32(sb, _mm_madd_epi16(vb, ones));
+        }
+
+        int32_t lanes[5][4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes[0]), aa);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes[1]), bb);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes[2]), ab);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes[3]), sa);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes[4]), sb);
+        for (int lane = 0; lane < 4; lane++) {
+            sums->aa += lanes[0][lane];
+            sums->bb += lanes[1][lane];
+            sums->ab += lanes[2][lane];
+            sums->a += lanes[3][lane];
+            sums->b += lanes[4][lane];
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        sums->aa += a[i] * a[i];
+        sums->bb += b[i] * b[i];
+        sums->ab += a[i] * b[i];
+        sums->a += a[i];
+        sums->b += b[i];
+    }
+}
+
+// Sum of squared differences on one axis, expanded so only integer sums
+// depend on the individual points
+static double axisSquaredDistance(const AxisSums& sums, size_t n, double offset1, double scale1,
+                                  double offset2, double scale2) {
+    double dOffset = offset1 - offset2;
+    double total = n * dOffset * dOffset
+                 + scale1 * scale1 * sums.aa
+                 + scale2 * scale2 * sums.bb
+                 - 2.0 * scale1 * scale2 * sums.ab
+                 + 2.0 * dOffset * (scale1 * sums.a - scale2 * sums.b);
+    return total > 0 ? total : 0;
+}
+
+double quantizedTrajectoryRmsDistance(const QuantizedTrajectory& traj1,
+                                      const QuantizedTrajectory& traj2) {
+    size_t n = std::min(traj1.size(), traj2.size());
+    if (n == 0) return 0;
+
+    AxisSums sx, sy, sz;
+    accumulateAxis(traj1.x.data(), traj2.x.data(), n, &sx);
+    accumulateAxis(traj1.y.data(), traj2.y.data(), n, &sy);
+    accumulateAxis(traj1.z.data(), traj2.z.data(), n, &sz);
+
+    double total = axisSquaredDistance(sx, n, traj1.offset.x, traj1.scale.x, traj2.offset.x, traj2.scale.x)
+                 + axisSquaredDistance(sy, n, traj1.offset.y, traj1.scale.y, traj2.offset.y, traj2.scale.y)
+                 + axisSquaredDistance(sz, n, traj1.offset.z, traj1.scale.z, traj2.offset.z, traj2.scale.z);
+    return std::sqrt(total / n);
+}
+
+double calculateTrajectorySimilarity(const QuantizedTrajectory& traj1,
+                                     const QuantizedTrajectory& traj2) {
+    if (traj1.size() == 0 || traj2.size() == 0) return 0;
+    return 1.0 / (1.0 + quantizedTrajectoryRmsDistance(traj1, traj2));
+}
@@ -0,0 +1,43 @@
+/*
+ * Quantized Trajectory Encoding for Basketball Haptic Training System
+ * Standard C++ version for Visual Studio Code
+ *
+ * Trajectories are stored as int16 per axis with a per-trajectory offset
+ * and scale (6 bytes per point instead of 24), and compared directly in
+ * the integer domain.
+ */
+
+#ifndef TRAJECTORY_QUANT_H
+#define TRAJECTORY_QUANT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "sensors.h"
+
+// Quantization Configuration
+// 14-bit range: two int16 products summed still fit in an int32 lane
+const int TRAJECTORY_QUANT_MAX = 8191;
+
+struct QuantizedTrajectory {
+    Vector3D offset;  // Centre of each axis range
+    Vector3D scale;   // Position units per quantization step
+    std::vector<int16_t> x, y, z;
+
+    size_t size() const { return x.size(); }
+};
+
+// Encoding Functions
+void quantizeTrajectory(const std::vector<Vector3D>& trajectory, QuantizedTrajectory* out);
+void dequantizeTrajectory(const QuantizedTrajectory& quantized, std::vector<Vector3D>* out);
+size_t quantizedTrajectoryBytes(size_t points);
+void serializeQuantizedTrajectory(const QuantizedTrajectory& quantized, std::vector<uint8_t>* out);
+bool deserializeQuantizedTrajectory(const uint8_t* data, size_t length, QuantizedTrajectory* out);
+
+// Matching Functions (integer fast path of calculateTrajectorySimilarity)
+double quantizedTrajectoryRmsDistance(const QuantizedTrajectory& traj1,
+                                      const QuantizedTrajectory& traj2);
+double calculateTrajectorySimilarity(const QuantizedTrajectory& traj1,
+                                     const QuantizedTrajectory& traj2);
+
+#endif // TRAJECTORY_QUANT_H